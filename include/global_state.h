@@ -13,6 +13,7 @@
 #define CMD_WIFI_SCAN    (1 << 0)
 #define CMD_WIFI_CONN    (1 << 1)
 #define CMD_WIFI_RESET   (1 << 2)
+#define CMD_ASSET_BAKE   (1 << 4)
 
 // --- Task Handles ---
 extern TaskHandle_t systemTaskHandle;
@@ -33,21 +34,40 @@ struct SpotifyState {
     String client_id;
     String client_secret;
     String refresh_token;
+    String access_token;
+    uint32_t access_token_expiry = 0; // Unix time, 0 if unknown (clock wasn't set)
+    uint32_t access_token_issued_ms = 0; // millis() when issued this boot, 0 if restored from flash
     String auth_url = "";
 
     String current_track_id = "";
     String current_track_title =  "Nothing Playing";
     String current_track_artist = "-";
     String current_track_url = "";
+    int8_t current_art_asset = -1;        // AssetId for built-in art, -1 when it comes from the url
     String current_track_device_name = "No Device";
     int current_track_duration_ms = 0;
-    int current_track_progress_ms = 0;
+    int current_track_progress_ms = 0;    // Progress at the last poll
+    uint32_t progress_anchor_time = 0;    // millis() when that progress was read
+    mutable portMUX_TYPE progress_lock = portMUX_INITIALIZER_UNLOCKED;  // Keeps the two above a pair
     bool is_playing = false;
+    volatile bool has_playback = false;   // Any session at all, paused counts - read by the sleep timer
     uint32_t album_background_cover  = 0x3F5C67;
     //uint32_t album_average_colour  = 0xB1A69D;
 
-    bool needs_art_update = false;
-    bool needs_text_update = false;
+    // Progress is read from other tasks - always set and read it with its anchor
+    void setProgress(int progress_ms, uint32_t anchor) {
+        portENTER_CRITICAL(&progress_lock);
+        current_track_progress_ms = progress_ms;
+        progress_anchor_time = anchor;
+        portEXIT_CRITICAL(&progress_lock);
+    }
+
+    void readProgress(int& progress_ms, uint32_t& anchor) const {
+        portENTER_CRITICAL(&progress_lock);
+        progress_ms = current_track_progress_ms;
+        anchor = progress_anchor_time;
+        portEXIT_CRITICAL(&progress_lock);
+    }
 };
 
 
@@ -58,6 +78,7 @@ enum SystemStatus {
 };
 
 struct SystemState {
+    bool boot_failed = false;  // FS / secrets missing - UI shows the failure screen
     bool setup_complete = false;
     bool spotify_linked = false;
 
@@ -83,14 +104,40 @@ enum WifiStatus {
     WIFI_ERROR
 };
 
+struct WifiNetwork {
+    String ssid;
+    int32_t rssi = 0;         // Strongest BSSID seen for this SSID
+    uint8_t channel = 0;
+    uint8_t bssid[6] = {};
+    uint8_t auth = 0;         // wifi_auth_mode_t
+};
+
+// Last successful association, lets a reconnect skip the scan.
+// Addresses always come from DHCP - a cached IP could belong to someone else by now
+struct WifiLeaseCache {
+    bool valid = false;
+    String ssid;            // Only applies to this network
+    uint8_t bssid[6] = {};
+    int32_t channel = 0;
+};
+
 struct NetworkState {
     WifiStatus status = WIFI_IDLE;
-    bool wifi_connected = false;
+    bool wifi_connected = false;   // Link is up right now (cleared by the link monitor)
     String ip = "0.0.0.0";
 
+    // Link monitor - status stays WIFI_CONNECTED while it reconnects in the background
+    bool link_lost = false;
+    uint32_t link_lost_time = 0;
+    uint32_t last_reconnect_ms = 0;
+    uint32_t reconnects = 0;
+
     String selected_ssid = "";
     String selected_pass = "";
-    std::vector<String> found_ssids;
+    std::vector<WifiNetwork> found_networks; // Sorted by signal, guarded by WifiManager
+    uint32_t scan_version = 0;               // Bumped every time found_networks changes
+
+    WifiLeaseCache lease;
 };
 
 extern SystemState systemState;
@@ -25,6 +25,7 @@
 #define LV_USE_ARC 1
 
 #define LV_USE_QRCODE 1
+#define LV_USE_SNAPSHOT 1
 
 #define LV_USE_SJPG 1
 #define LV_USE_TJPGD 1
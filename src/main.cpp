@@ -2,9 +2,15 @@
 #include <LittleFS.h>
 #include "hal/display.h"
 #include "global_state.h"
+#include "network/StatusServer.h"
 #include "network/WifiManager.h"
 #include "spotify/SpotifyManager.h"
+#include "system/BootSequencer.h"
+#include "system/Lifecycle.h"
 #include "system/SystemManager.h"
+#include "system/Telemetry.h"
+#include "system/TraceLog.h"
+#include "ui/AssetStore.h"
 #include "ui/UIManager.h"
 
 SystemState systemState;
@@ -18,12 +24,16 @@ void TaskSystem(void *pvParameters);
 
 // Tasks
 TaskHandle_t systemTaskHandle = NULL;
+static TaskHandle_t graphicsTaskHandle = NULL;
 
-void setup() {
-    Serial.begin(115200);
-    delay(2000);
+// --- Boot Stages ---
+static volatile bool hard_reset_requested = false;
+
+void bootHal() {
     halSetup();
+}
 
+void bootUi() {
 #if LV_USE_SJPG == 0
     Serial.println("WARNING: LV_USE_SJPG is DISABLED in lv_conf.h!");
 #else
@@ -31,70 +41,132 @@ void setup() {
 #endif
 
     UIManager::getInstance().init();
+}
 
-    if (!LittleFS.begin(true)) UIManager::getInstance().showFailure();
-    delay(100);
+void bootFs() {
+    if (!LittleFS.begin(true)) {
+        Serial.println("System: LittleFS mount failed");
+        systemState.boot_failed = true;
+    }
+}
 
-    SystemManager::getInstance().init();
-    delay(500);
+void bootConfig() {
+    if (systemState.boot_failed) return;
 
+    SystemManager::getInstance().init();
     SpotifyManager::getInstance().init();
+}
 
-    // UI Task (Core 1)
-    xTaskCreatePinnedToCore(TaskGraphics, "Graphics", 32768, NULL, 5, NULL, 1);
-
-    // Network Task (Core 0)
-    xTaskCreatePinnedToCore(TaskSystem, "System", 32768, NULL, 1, &systemTaskHandle, 0);
+void bootWifi() {
+    // Saved network - start associating while the display is still coming up
+    if (networkState.status == WIFI_CONNECTING) {
+        WifiManager::getInstance().beginConnect();
+    }
 }
 
-void handleHardResetCheck() {
+void bootResetWindow() {
     pinMode(0, INPUT_PULLUP);
     uint32_t start_time = millis();
 
     while(millis() - start_time < 3000) {
         if (digitalRead(0) == LOW) {
-            Serial.println("DEBUG: Reset Triggered!");
-            LittleFS.remove("/config.json");
-            LittleFS.remove("/tokens.json");
-            systemState.setup_complete = false;
-            systemState.spotify_linked = false;
-            UIManager::getInstance().showContextScreen("Resetting...");
-            lv_timer_handler();
-            vTaskDelay(pdMS_TO_TICKS(2000));
-            ESP.restart();
+            hard_reset_requested = true;
+            return;
         }
-        lv_timer_handler();
         vTaskDelay(pdMS_TO_TICKS(20));
     }
 }
 
+void setup() {
+    Serial.begin(115200);
+    TraceLog::getInstance().begin();
+
+    BootSequencer& boot = BootSequencer::getInstance();
+    boot.addStage(BOOT_STAGE_HAL, "hal", 0, bootHal, 1);
+    boot.addStage(BOOT_STAGE_UI, "ui", BOOT_BIT(BOOT_STAGE_HAL), bootUi, 1);
+    boot.addStage(BOOT_STAGE_FS, "fs", 0, bootFs, 0);
+    boot.addStage(BOOT_STAGE_CONFIG, "config", BOOT_BIT(BOOT_STAGE_FS), bootConfig, 0);
+    boot.addStage(BOOT_STAGE_WIFI, "wifi", BOOT_BIT(BOOT_STAGE_CONFIG), bootWifi, 0);
+    // Button shares GPIO0 with the panel bus, so only take it over once the panel is up
+    boot.addStage(BOOT_STAGE_RESET_WINDOW, "reset_window", BOOT_BIT(BOOT_STAGE_HAL), bootResetWindow, 1);
+    boot.run();
+
+    // UI Task (Core 1)
+    xTaskCreatePinnedToCore(TaskGraphics, "Graphics", 32768, NULL, 5, &graphicsTaskHandle, 1);
+
+    // Network Task (Core 0)
+    xTaskCreatePinnedToCore(TaskSystem, "System", 32768, NULL, 1, &systemTaskHandle, 0);
+
+    // Metrics, state and the OAuth callback on the local network
+    StatusServer::getInstance().start();
+
+    // Only used if the scheduler can't list every task itself
+    Telemetry::getInstance().watchTask(graphicsTaskHandle);
+    Telemetry::getInstance().watchTask(systemTaskHandle);
+}
+
+void handleHardReset() {
+    Serial.println("DEBUG: Reset Triggered!");
+    LittleFS.remove("/config.json");
+    LittleFS.remove("/tokens.json");
+    systemState.setup_complete = false;
+    systemState.spotify_linked = false;
+    UIManager::getInstance().showContextScreen("Resetting...");
+    lv_timer_handler();
+    vTaskDelay(pdMS_TO_TICKS(2000));
+    ESP.restart();
+}
+
 
 // --- CORE 1: Handle Screen Updates ---
 void TaskGraphics(void *pvParameters) {
+    BootSequencer& boot = BootSequencer::getInstance();
+    boot.waitFor(BOOT_BIT(BOOT_STAGE_UI));
+
     UIManager::getInstance().showSplashScreen();
-    handleHardResetCheck();
+
+    // Hold the splash until we know which screen to show
+    while (!boot.isDone(BOOT_BIT(BOOT_STAGE_CONFIG))) {
+        lv_timer_handler();
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
 
     static uint32_t last_progress = 0;
 
     for (;;) {
+        if (hard_reset_requested) handleHardReset();
+
+        // Lifecycle timers - WiFi settle, idle -> sleep
+        Lifecycle::getInstance().update();
+
+        // Sleep can be left from any task, the screen is rebuilt here
+        if (SystemManager::getInstance().takeWake()) SystemManager::getInstance().exitSleepMode();
+
         if (systemState.status != SYSTEM_STATUS_SLEEP) {
 
             if (spotifyState.status == SPOTIFY_READY && spotifyState.is_playing) {
-                spotifyState.current_track_progress_ms += 33;
+                // Extrapolate from the last poll instead of stepping per frame
+                int progress_ms;
+                uint32_t anchor;
+                spotifyState.readProgress(progress_ms, anchor);
+                uint32_t progress = progress_ms + (millis() - anchor);
 
-                if (spotifyState.current_track_progress_ms != last_progress) {
+                if (progress != last_progress) {
                     UIManager::getInstance().setTrackProgress(
-                        spotifyState.current_track_progress_ms,
+                        progress,
                         spotifyState.current_track_duration_ms
                     );
-                    last_progress = spotifyState.current_track_progress_ms;
+                    last_progress = progress;
                 }
             }
 
 
+            uint32_t frame_start = micros();
+
             UIManager::getInstance().update();
 
             lv_timer_handler();
+            Telemetry::getInstance().recordFrame(micros() - frame_start);
             // 33ms ~30fps
             vTaskDelay(pdMS_TO_TICKS(33)); // 25 -> 33
         }
@@ -109,9 +181,15 @@ void TaskGraphics(void *pvParameters) {
 void TaskSystem(void *pvParameters) {
     uint32_t ulTaskNotifiedValue;
 
+    // bootWifi starts the saved network's association - WifiManager is ours once it's done
+    BootSequencer::getInstance().waitFor(BOOT_BIT(BOOT_STAGE_CONFIG) | BOOT_BIT(BOOT_STAGE_WIFI));
+
+    uint32_t wait_ms = 500;
+
     for (;;) {
 
-        if (xTaskNotifyWait(0, ULONG_MAX, &ulTaskNotifiedValue, pdMS_TO_TICKS(100)) == pdPASS) {
+        // Sleeps until the next tick, or wakes early for a command
+        if (xTaskNotifyWait(0, ULONG_MAX, &ulTaskNotifiedValue, pdMS_TO_TICKS(wait_ms)) == pdPASS) {
 
             if (ulTaskNotifiedValue & CMD_WIFI_SCAN) {
                 WifiManager::getInstance().processScan();
@@ -124,39 +202,27 @@ void TaskSystem(void *pvParameters) {
             if (ulTaskNotifiedValue & CMD_WIFI_RESET) {
                 WifiManager::getInstance().processReset();
             }
+
+            if (ulTaskNotifiedValue & CMD_ASSET_BAKE) {
+                AssetStore::getInstance().writePending();
+            }
         }
 
         // Non-Command Logic (e.g. Checking Wi-Fi status)
         WifiManager::getInstance().update();
-        SystemManager::getInstance().update();
 
-        // Only update if on WiFi
+        // Only update if on WiFi - sleep / wake runs off the poll and the lifecycle timers
         if (networkState.wifi_connected) {
-            // Handle sleeping
-            if (systemState.status == SYSTEM_STATUS_IDLE) {
-
-                unsigned long idleTime = millis() - systemState.time_first_np;
-                unsigned long currentTimeout = (spotifyState.current_track_id == "NOT_PLAYING")
-                                           ? SLEEP_TIMEOUT_MS
-                                           : PAUSE_SLEEP_TIMEOUT_MS;
-
-                if (idleTime >= currentTimeout) {
-                    Serial.println("SLEEP DEBUG: TIMEOUT ELAPSED - SLEEPING...");
-                    systemState.status = SYSTEM_STATUS_SLEEP;
-                    SystemManager::getInstance().enterSleepMode();
-                }
-            }
-
             SpotifyManager::getInstance().update();
-
-            if (systemState.status != SYSTEM_STATUS_ACTIVE && spotifyState.is_playing) {
-                systemState.status = SYSTEM_STATUS_ACTIVE;
-                SystemManager::getInstance().exitSleepMode();
-            }
         }
 
-        int delayTime = (systemState.status == SYSTEM_STATUS_ACTIVE) ? 500 : 2000;
-        vTaskDelay(pdMS_TO_TICKS(delayTime));
+        // Hand the status server this tick's view, it serves from its own task
+        StatusServer::getInstance().publish();
+
+        // Stacks, CPU split and heap every TELEMETRY_INTERVAL_MS
+        Telemetry::getInstance().update();
+
+        wait_ms = (systemState.status == SYSTEM_STATUS_ACTIVE) ? 500 : 2000;
     }
 }
 
@@ -0,0 +1,232 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "DnsCache.h"
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#define DNS_PORT 53
+#define DNS_QUERY_TIMEOUT_MS 1000
+#define DNS_FALLBACK_TTL_S 300  // hostByName() doesn't expose the TTL
+#define DNS_MIN_TTL_S 30
+#define DNS_MAX_TTL_S 3600
+
+static const char* PREWARM_HOSTS[] = {
+    "api.spotify.com",
+    "accounts.spotify.com",
+    "i.scdn.co",
+};
+
+// --- Cache ---
+
+bool DnsCache::resolve(const char* host, IPAddress& out) {
+    if (!host || !*host) return false;
+
+    // Dotted quads don't need a lookup
+    if (out.fromString(host)) return true;
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    Entry* entry = find(host);
+    uint32_t now = millis();
+
+    if (entry && now - entry->fetched_at < entry->ttl_ms) {
+        entry->last_used = now;
+        out = IPAddress(entry->ip);
+        hits++;
+        xSemaphoreGive(mutex);
+        return true;
+    }
+    misses++;
+    xSemaphoreGive(mutex);
+
+    // Lookup happens outside the lock so one slow query doesn't stall other tasks
+    uint32_t ip = 0;
+    uint32_t ttl_s = 0;
+    bool ok = query(host, ip, ttl_s);
+
+    if (!ok) {
+        IPAddress fallback;
+        if (WiFi.hostByName(host, fallback) == 1 && (uint32_t)fallback != 0) {
+            ip = (uint32_t)fallback;
+            ttl_s = DNS_FALLBACK_TTL_S;
+            ok = true;
+        }
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    entry = find(host);
+
+    if (!ok) {
+        // A stale answer is better than no answer while DNS is flaky
+        bool stale = entry && entry->ip != 0;
+        if (stale) out = IPAddress(entry->ip);
+        xSemaphoreGive(mutex);
+        if (stale) Serial.printf("DNS: Lookup for %s failed, using stale entry\n", host);
+        else Serial.printf("DNS: Lookup for %s failed\n", host);
+        return stale;
+    }
+
+    if (!entry) {
+        entry = slotFor(host);
+        strlcpy(entry->host, host, sizeof(entry->host));
+    }
+    entry->ip = ip;
+    entry->fetched_at = now;
+    entry->ttl_ms = constrain(ttl_s, DNS_MIN_TTL_S, DNS_MAX_TTL_S) * 1000;
+    entry->last_used = now;
+    xSemaphoreGive(mutex);
+
+    out = IPAddress(ip);
+    return true;
+}
+
+void DnsCache::prewarm() {
+    uint32_t start = millis();
+    int resolved = 0;
+
+    for (const char* host : PREWARM_HOSTS) {
+        IPAddress ip;
+        if (resolve(host, ip)) resolved++;
+    }
+
+    Serial.printf("DNS: Prewarmed %d/%d hosts in %lums\n",
+        resolved, (int)(sizeof(PREWARM_HOSTS) / sizeof(PREWARM_HOSTS[0])), millis() - start);
+}
+
+void DnsCache::clear() {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    for (Entry& entry : entries) entry = Entry();
+    xSemaphoreGive(mutex);
+}
+
+DnsCache::Entry* DnsCache::find(const char* host) {
+    for (Entry& entry : entries) {
+        if (entry.host[0] && strcasecmp(entry.host, host) == 0) return &entry;
+    }
+    return nullptr;
+}
+
+DnsCache::Entry* DnsCache::slotFor(const char* host) {
+    Entry* oldest = &entries[0];
+    for (Entry& entry : entries) {
+        if (!entry.host[0]) return &entry;
+        if (entry.last_used < oldest->last_used) oldest = &entry;
+    }
+    return oldest;
+}
+
+// --- Wire Query ---
+
+static size_t skipName(const uint8_t* buf, size_t len, size_t pos) {
+    while (pos < len) {
+        uint8_t label = buf[pos];
+        if (label == 0) return pos + 1;
+        if ((label & 0xC0) == 0xC0) return pos + 2;  // Compression pointer ends the name
+        pos += label + 1;
+    }
+    return len;
+}
+
+// Sends a single A query to the configured DNS server and reads the answer TTL,
+// which lwIP's resolver keeps to itself
+bool DnsCache::query(const char* host, uint32_t& ip, uint32_t& ttl_s) {
+    IPAddress server = WiFi.dnsIP(0);
+    if ((uint32_t)server == 0) return false;
+
+    uint8_t packet[300];
+    uint16_t id = (uint16_t)esp_random();
+
+    // Header: id, recursion desired, one question
+    memset(packet, 0, 12);
+    packet[0] = id >> 8;
+    packet[1] = id & 0xFF;
+    packet[2] = 0x01;
+    packet[5] = 0x01;
+    size_t pos = 12;
+
+    // QNAME as length-prefixed labels
+    const char* label = host;
+    while (*label) {
+        const char* dot = strchr(label, '.');
+        size_t n = dot ? dot - label : strlen(label);
+        if (n == 0 || n > 63 || pos + n + 6 > sizeof(packet)) return false;
+        packet[pos++] = n;
+        memcpy(&packet[pos], label, n);
+        pos += n;
+        label += n + (dot ? 1 : 0);
+    }
+    packet[pos++] = 0;
+    packet[pos++] = 0x00; packet[pos++] = 0x01;  // QTYPE A
+    packet[pos++] = 0x00; packet[pos++] = 0x01;  // QCLASS IN
+
+    WiFiUDP udp;
+    if (!udp.begin(0)) return false;
+    udp.beginPacket(server, DNS_PORT);
+    udp.write(packet, pos);
+    if (!udp.endPacket()) {
+        udp.stop();
+        return false;
+    }
+
+    int len = 0;
+    uint32_t start = millis();
+    while (millis() - start < DNS_QUERY_TIMEOUT_MS) {
+        if (udp.parsePacket() > 0) {
+            len = udp.read(packet, sizeof(packet));
+            if (len >= 12 && packet[0] == (id >> 8) && packet[1] == (id & 0xFF)) break;
+            len = 0;
+        }
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    udp.stop();
+
+    if (len < 12 || (packet[3] & 0x0F) != 0) return false;  // RCODE
+
+    uint16_t questions = (packet[4] << 8) | packet[5];
+    uint16_t answers = (packet[6] << 8) | packet[7];
+
+    pos = 12;
+    for (uint16_t i = 0; i < questions; i++) pos = skipName(packet, len, pos) + 4;
+
+    // CNAME chains come first - the usable lifetime is the shortest TTL on the way to the A record
+    uint32_t min_ttl = UINT32_MAX;
+    for (uint16_t i = 0; i < answers && pos < (size_t)len; i++) {
+        pos = skipName(packet, len, pos);
+        if (pos + 10 > (size_t)len) return false;
+
+        uint16_t type = (packet[pos] << 8) | packet[pos + 1];
+        uint32_t ttl = ((uint32_t)packet[pos + 4] << 24) | ((uint32_t)packet[pos + 5] << 16) |
+                       ((uint32_t)packet[pos + 6] << 8) | packet[pos + 7];
+        uint16_t rdlen = (packet[pos + 8] << 8) | packet[pos + 9];
+        pos += 10;
+        if (pos + rdlen > (size_t)len) return false;
+
+        if (ttl < min_ttl) min_ttl = ttl;
+
+        if (type == 1 && rdlen == 4) {
+            ip = IPAddress(packet[pos], packet[pos + 1], packet[pos + 2], packet[pos + 3]);
+            ttl_s = min_ttl;
+            return true;
+        }
+        pos += rdlen;
+    }
+
+    return false;
+}
+
+// --- Client ---
+
+int CachedSecureClient::connect(const char* host, uint16_t port) {
+    IPAddress ip;
+    if (!DnsCache::getInstance().resolve(host, ip)) return 0;
+
+    // Host is still passed through for SNI. All our clients run with setInsecure()
+    return WiFiClientSecure::connect(ip, port, host, nullptr, nullptr, nullptr);
+}
+
+int CachedSecureClient::connect(const char* host, uint16_t port, int32_t timeout) {
+    _timeout = timeout;
+    return connect(host, port);
+}
@@ -0,0 +1,66 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef DNSCACHE_H
+#define DNSCACHE_H
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+// Small resolver cache for the handful of hosts we talk to.
+// Entries live for the TTL the DNS server gave us
+class DnsCache {
+public:
+    static DnsCache& getInstance() {
+        static DnsCache instance;
+        return instance;
+    }
+
+    bool resolve(const char* host, IPAddress& out);
+
+    // Resolves the Spotify API, accounts and image CDN hosts ahead of the first request
+    void prewarm();
+    void clear();
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+
+private:
+    DnsCache() { mutex = xSemaphoreCreateMutex(); }
+
+    struct Entry {
+        char host[48] = "";
+        uint32_t ip = 0;
+        uint32_t fetched_at = 0;   // millis()
+        uint32_t ttl_ms = 0;
+        uint32_t last_used = 0;
+    };
+
+    static const int CACHE_SIZE = 8;
+    Entry entries[CACHE_SIZE];
+    SemaphoreHandle_t mutex = nullptr;
+
+    Entry* find(const char* host);
+    Entry* slotFor(const char* host);
+    static bool query(const char* host, uint32_t& ip, uint32_t& ttl_s);
+
+    DnsCache(const DnsCache&) = delete;
+    void operator=(const DnsCache&) = delete;
+};
+
+// WiFiClientSecure that looks hosts up through DnsCache, SNI still uses the hostname
+class CachedSecureClient : public WiFiClientSecure {
+public:
+    using WiFiClientSecure::connect;
+
+    int connect(const char* host, uint16_t port) override;
+    int connect(const char* host, uint16_t port, int32_t timeout) override;
+
+    // Raw socket under the TLS session, for select()
+    int socketFd() const { return sslclient ? sslclient->socket : -1; }
+};
+
+
+
+#endif //DNSCACHE_H
@@ -0,0 +1,199 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "HttpDownloader.h"
+
+#include <lwip/sockets.h>
+
+#define DOWNLOAD_MAX_RESUMES 2
+#define DOWNLOAD_INITIAL_BUFFER (16 * 1024)
+#define DOWNLOAD_READ_BLOCK 4096
+#define DOWNLOAD_LINE_MAX 64
+
+bool HttpDownloader::fetch(const String& url, DownloadResult& out, uint32_t timeout_ms) {
+    out = DownloadResult();
+    capacity = 0;
+    wait_us = 0;
+
+    uint32_t start = millis();
+    uint32_t deadline = start + timeout_ms;
+
+    for (int attempt = 0; attempt <= DOWNLOAD_MAX_RESUMES; attempt++) {
+        size_t offset = out.len;
+        int code = request(url, offset);
+        out.http_code = code;
+
+        if (offset > 0 && code == HTTP_CODE_PARTIAL_CONTENT) {
+            out.stats.resumes++;
+        } else if (code == HTTP_CODE_OK) {
+            out.len = 0;  // Fresh body, or the server ignored the Range
+        } else {
+            Serial.printf("Download: HTTP %d for %s\n", code, url.c_str());
+            if (code > 0) out.retry_after_s = http.header("Retry-After").toInt();
+            break;
+        }
+
+        bool chunked = http.header("Transfer-Encoding").equalsIgnoreCase("chunked");
+        out.stats.chunked |= chunked;
+
+        BodyState state = readBody(out, http.getSize(), chunked, deadline);
+        if (state == BODY_DONE) {
+            out.complete = true;
+            http.end();
+            break;
+        }
+
+        // Connection is mid-body, it can't be reused
+        client.stop();
+        http.end();
+
+        if (state == BODY_FAILED || (int32_t)(deadline - millis()) <= 0) break;
+        Serial.printf("Download: Short transfer at %u bytes, resuming\n", out.len);
+    }
+
+    DownloadStats& stats = out.stats;
+    stats.bytes = out.len;
+    stats.elapsed_ms = millis() - start;
+    stats.wait_us = wait_us;
+    stats.cpu_us = stats.elapsed_ms * 1000 > wait_us ? stats.elapsed_ms * 1000 - wait_us : 0;
+    stats.bytes_per_sec = stats.elapsed_ms ? (uint64_t)stats.bytes * 1000 / stats.elapsed_ms : 0;
+    stats.cpu_ns_per_byte = stats.bytes ? (uint64_t)stats.cpu_us * 1000 / stats.bytes : 0;
+    last_stats = stats;
+
+    Serial.printf("Download: %u bytes in %u ms (%u KB/s, %u ns/B CPU, %u resumes%s)\n",
+        stats.bytes, stats.elapsed_ms, stats.bytes_per_sec / 1024, stats.cpu_ns_per_byte,
+        stats.resumes, stats.chunked ? ", chunked" : "");
+
+    if (!out.complete) {
+        free(out.data);
+        out.data = nullptr;
+        out.len = 0;
+    }
+    return out.complete;
+}
+
+int HttpDownloader::request(const String& url, size_t offset) {
+    client.setInsecure();
+    http.setReuse(true);
+    http.setUserAgent("ESP32-Spotify-Mate");
+
+    if (!http.begin(client, url)) return -1;
+
+    const char* headers[] = { "Transfer-Encoding", "Retry-After" };
+    http.collectHeaders(headers, 2);
+    if (offset > 0) http.addHeader("Range", "bytes=" + String(offset) + "-");
+
+    return http.GET();
+}
+
+// --- Body ---
+
+HttpDownloader::BodyState HttpDownloader::readBody(DownloadResult& out, int32_t length, bool chunked, uint32_t deadline) {
+    if (chunked) return readChunked(out, deadline);
+    if (length >= 0) return readExact(out, length, deadline);
+
+    // No length and not chunked - the body ends when the server closes
+    while (true) {
+        if (!waitReadable(deadline)) return client.connected() ? BODY_SHORT : BODY_DONE;
+        if (!grow(out, out.len + DOWNLOAD_READ_BLOCK)) return BODY_FAILED;
+
+        int n = client.read(&out.data[out.len], DOWNLOAD_READ_BLOCK);
+        if (n > 0) out.len += n;
+    }
+}
+
+HttpDownloader::BodyState HttpDownloader::readChunked(DownloadResult& out, uint32_t deadline) {
+    char line[DOWNLOAD_LINE_MAX];
+
+    while (true) {
+        if (!readLine(line, sizeof(line), deadline)) return BODY_SHORT;
+
+        // Size is hex, optionally followed by ;extensions
+        size_t size = strtoul(line, nullptr, 16);
+        if (size == 0) {
+            // Skip any trailers up to the blank line
+            while (readLine(line, sizeof(line), deadline) && line[0]) {}
+            return BODY_DONE;
+        }
+
+        BodyState state = readExact(out, size, deadline);
+        if (state != BODY_DONE) return state;
+
+        // CRLF after every chunk
+        if (!readLine(line, sizeof(line), deadline)) return BODY_SHORT;
+    }
+}
+
+HttpDownloader::BodyState HttpDownloader::readExact(DownloadResult& out, size_t count, uint32_t deadline) {
+    if (!grow(out, out.len + count)) return BODY_FAILED;
+
+    while (count > 0) {
+        if (!waitReadable(deadline)) return BODY_SHORT;
+
+        int n = client.read(&out.data[out.len], count);
+        if (n <= 0) continue;
+        out.len += n;
+        count -= n;
+    }
+    return BODY_DONE;
+}
+
+bool HttpDownloader::readLine(char* line, size_t max, uint32_t deadline) {
+    size_t len = 0;
+
+    while (true) {
+        if (!waitReadable(deadline)) return false;
+
+        int c = client.read();
+        if (c < 0) continue;
+        if (c == '\n') break;
+        if (c == '\r') continue;
+        if (len + 1 >= max) return false;
+        line[len++] = (char)c;
+    }
+
+    line[len] = '\0';
+    return true;
+}
+
+// Sleeps on the socket rather than polling available() with delay(1).
+// TLS can hold a decrypted record the socket no longer shows, so available() goes first
+bool HttpDownloader::waitReadable(uint32_t deadline) {
+    while (true) {
+        if (client.available() > 0) return true;
+        if (!client.connected()) return false;
+
+        int32_t left = (int32_t)(deadline - millis());
+        int fd = client.socketFd();
+        if (left <= 0 || fd < 0) return false;
+
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(fd, &readable);
+        timeval tv = { left / 1000, (left % 1000) * 1000 };
+
+        uint32_t t = micros();
+        int ready = select(fd + 1, &readable, nullptr, nullptr, &tv);
+        wait_us += micros() - t;
+
+        if (ready <= 0) return false;
+    }
+}
+
+bool HttpDownloader::grow(DownloadResult& out, size_t needed) {
+    if (needed <= capacity) return true;
+
+    size_t size = capacity ? capacity * 2 : DOWNLOAD_INITIAL_BUFFER;
+    if (size < needed) size = needed;
+
+    uint8_t* data = (uint8_t*)ps_realloc(out.data, size);
+    if (!data) {
+        Serial.printf("Download: Out of PSRAM growing to %u bytes\n", size);
+        return false;
+    }
+
+    out.data = data;
+    capacity = size;
+    return true;
+}
@@ -0,0 +1,63 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef HTTPDOWNLOADER_H
+#define HTTPDOWNLOADER_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+
+#include "DnsCache.h"
+
+struct DownloadStats {
+    uint32_t bytes = 0;
+    uint32_t elapsed_ms = 0;     // Request sent -> last byte
+    uint32_t wait_us = 0;        // Blocked in select(), not burning CPU
+    uint32_t cpu_us = 0;         // Everything else - TLS, chunk parsing, copies
+    uint32_t bytes_per_sec = 0;
+    uint32_t cpu_ns_per_byte = 0;
+    uint8_t resumes = 0;
+    bool chunked = false;
+};
+
+// Body lands in PSRAM, caller owns data and frees it
+struct DownloadResult {
+    uint8_t* data = nullptr;
+    size_t len = 0;
+    int http_code = 0;
+    uint32_t retry_after_s = 0;     // From a 429
+    bool complete = false;
+    DownloadStats stats;
+};
+
+// GETs a whole body into a growable PSRAM buffer.
+// Handles Content-Length, chunked and read-until-close bodies, waits on the
+// socket with a deadline and picks up short transfers with a Range request
+class HttpDownloader {
+public:
+    bool fetch(const String& url, DownloadResult& out, uint32_t timeout_ms = 8000);
+
+    const DownloadStats& getLastStats() const { return last_stats; }
+
+private:
+    CachedSecureClient client;
+    HTTPClient http;
+    DownloadStats last_stats;
+    size_t capacity = 0;    // Of the current result buffer
+    uint32_t wait_us = 0;
+
+    enum BodyState { BODY_DONE, BODY_SHORT, BODY_FAILED };
+
+    int request(const String& url, size_t offset);
+    BodyState readBody(DownloadResult& out, int32_t length, bool chunked, uint32_t deadline);
+    BodyState readChunked(DownloadResult& out, uint32_t deadline);
+    BodyState readExact(DownloadResult& out, size_t count, uint32_t deadline);
+    bool readLine(char* line, size_t max, uint32_t deadline);
+    bool waitReadable(uint32_t deadline);
+    bool grow(DownloadResult& out, size_t needed);
+};
+
+
+
+#endif //HTTPDOWNLOADER_H
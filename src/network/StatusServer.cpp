@@ -0,0 +1,257 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "StatusServer.h"
+
+#include <ArduinoJson.h>
+#include <WiFi.h>
+#include <esp_heap_caps.h>
+
+#include "global_state.h"
+#include "spotify/RateLimiter.h"
+#include "spotify/SpotifyManager.h"
+#include "system/Lifecycle.h"
+#include "system/Telemetry.h"
+#include "system/TraceLog.h"
+#include "ui/ArtPipeline.h"
+
+void StatusServer::start() {
+    if (task) return;
+    // Below the system task, so serving a request only ever uses its idle time
+    xTaskCreatePinnedToCore(taskEntry, "StatusSrv", 8192, this, 0, &task, 0);
+}
+
+void StatusServer::taskEntry(void* arg) {
+    static_cast<StatusServer*>(arg)->run();
+}
+
+void StatusServer::run() {
+    while (!networkState.wifi_connected) vTaskDelay(pdMS_TO_TICKS(500));
+    begin();
+
+    for (;;) {
+        server.handleClient();
+        vTaskDelay(pdMS_TO_TICKS(STATUS_SERVER_POLL_MS));
+    }
+}
+
+void StatusServer::begin() {
+    server.on("/metrics", HTTP_GET, [this]() { handleMetrics(); });
+    server.on("/state", HTTP_GET, [this]() { handleState(); });
+    server.on(STATUS_SERVER_CALLBACK_PATH, HTTP_GET, [this]() { handleCallback(); });
+    server.onNotFound([this]() { handleOther(); });
+
+    server.begin();
+
+    StatusView snapshot;
+    copyView(snapshot);
+    Serial.printf("StatusServer: Listening on %s:%d\n", snapshot.ip.c_str(), STATUS_SERVER_PORT);
+}
+
+// --- Shared State ---
+void StatusServer::publish() {
+    SpotifyManager& spotify = SpotifyManager::getInstance();
+
+    xSemaphoreTake(view_mutex, portMAX_DELAY);
+    view.poll = spotify.getPollStats();
+    view.art_download = spotify.getArtDownloadStats();
+    view.ip = networkState.ip;
+    view.track_id = spotifyState.current_track_id;
+    view.track_title = spotifyState.current_track_title;
+    view.track_artist = spotifyState.current_track_artist;
+    view.track_device = spotifyState.current_track_device_name;
+    view.playing = spotifyState.is_playing;
+    view.duration_ms = spotifyState.current_track_duration_ms;
+    spotifyState.readProgress(view.progress_ms, view.progress_anchor_time);
+    xSemaphoreGive(view_mutex);
+}
+
+void StatusServer::copyView(StatusView& out) {
+    xSemaphoreTake(view_mutex, portMAX_DELAY);
+    out = view;
+    xSemaphoreGive(view_mutex);
+}
+
+void StatusServer::sendJson(int code, const String& body) {
+    request_count++;
+    server.sendHeader("Cache-Control", "no-store");
+    server.send(code, "application/json", body);
+}
+
+// --- Metrics ---
+static void writeHeap(JsonObject out, uint32_t caps) {
+    HeapTelemetry heap;
+    Telemetry::readHeap(heap, caps);
+    out["total"] = heap.total;
+    out["free"] = heap.free;
+    out["min_free"] = heap.min_free;
+    out["largest"] = heap.largest;
+}
+
+void StatusServer::handleMetrics() {
+    static TelemetrySnapshot telemetry;     // Too big for the stack
+    Telemetry::getInstance().getSnapshot(telemetry);
+
+    static StatusView snapshot;             // Only ever touched by the server task
+    copyView(snapshot);
+
+    JsonDocument doc;
+    doc["uptime_ms"] = millis();
+
+    const PollStats& poll = snapshot.poll;
+    JsonObject p = doc["poll"].to<JsonObject>();
+    p["polls"] = poll.polls;
+    p["failures"] = poll.failures;
+    p["unchanged"] = poll.unchanged_polls;
+    p["last_request_ms"] = poll.last_request_ms;
+    p["last_body_bytes"] = poll.last_body_bytes;
+    p["last_parse_us"] = poll.last_parse_us;
+    p["max_parse_us"] = poll.max_parse_us;
+    p["last_allocs"] = poll.last_allocs;
+
+    RateLimiterStats rate;
+    RateLimiter::getInstance().getStats(rate);
+    JsonObject r = doc["rate_limit"].to<JsonObject>();
+    r["tokens"] = rate.tokens;
+    r["throttled"] = rate.throttled;
+    r["blocked_ms"] = rate.blocked_ms;
+    r["last_retry_after_ms"] = rate.last_retry_after_ms;
+    JsonArray granted = r["granted"].to<JsonArray>();
+    JsonArray deferred = r["deferred"].to<JsonArray>();
+    for (int i = 0; i < RATE_PRIORITY_COUNT; i++) {
+        granted.add(rate.granted[i]);
+        deferred.add(rate.deferred[i]);
+    }
+
+    ArtPipelineStats pipeline = ArtPipeline::getLastStats();
+    const DownloadStats& download = snapshot.art_download;
+    JsonObject a = doc["art"].to<JsonObject>();
+    a["download_ms"] = download.elapsed_ms;
+    a["download_bytes"] = download.bytes;
+    a["download_bps"] = download.bytes_per_sec;
+    a["decode_us"] = pipeline.us;
+    a["fused"] = pipeline.fused;
+    a["psram_bytes_est"] = pipeline.psram_bytes_est;
+
+    JsonObject f = doc["frames"].to<JsonObject>();
+    f["count"] = telemetry.frames.count;
+    f["avg_us"] = telemetry.frames.avg_us;
+    f["max_us"] = telemetry.frames.max_us;
+    f["sampled_ms"] = telemetry.at_ms;
+
+    // Heap is read live, the rest of the telemetry is from the last sample
+    JsonObject heap = doc["heap"].to<JsonObject>();
+    writeHeap(heap["internal"].to<JsonObject>(), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    writeHeap(heap["psram"].to<JsonObject>(), MALLOC_CAP_SPIRAM);
+
+    JsonObject w = doc["wifi"].to<JsonObject>();
+    w["rssi"] = networkState.wifi_connected ? WiFi.RSSI() : 0;
+    w["reconnects"] = networkState.reconnects;
+    w["last_reconnect_ms"] = networkState.last_reconnect_ms;
+
+    if (telemetry.cpu_valid) {
+        JsonArray load = doc["core_load_permille"].to<JsonArray>();
+        for (int core = 0; core < portNUM_PROCESSORS; core++) load.add(telemetry.core_load_permille[core]);
+    }
+
+    JsonArray tasks = doc["tasks"].to<JsonArray>();
+    for (uint8_t i = 0; i < telemetry.task_count; i++) {
+        JsonObject t = tasks.add<JsonObject>();
+        t["name"] = telemetry.tasks[i].name;
+        t["stack_free"] = telemetry.tasks[i].stack_free;
+        t["priority"] = telemetry.tasks[i].priority;
+        if (telemetry.cpu_valid) t["cpu_permille"] = telemetry.tasks[i].cpu_permille;
+    }
+
+    Lifecycle& lifecycle = Lifecycle::getInstance();
+    JsonObject illegal = doc["illegal_transitions"].to<JsonObject>();
+    illegal["wifi"] = lifecycle.wifi.getIllegalCount();
+    illegal["spotify"] = lifecycle.spotify.getIllegalCount();
+    illegal["system"] = lifecycle.system.getIllegalCount();
+
+    doc["trace_dropped"] = TraceLog::getInstance().getDropped();
+    doc["requests"] = request_count;
+
+    String body;
+    serializeJson(doc, body);
+    sendJson(200, body);
+}
+
+// --- State ---
+static void writeMachine(JsonObject out, StateMachine& machine) {
+    out["state"] = machine.stateName(machine.current());
+
+    SmTrace trace[SM_TRACE_DEPTH];
+    uint8_t count = 0;
+    machine.copyTrace(trace, count);
+
+    JsonArray recent = out["recent"].to<JsonArray>();
+    for (uint8_t i = 0; i < count; i++) {
+        JsonObject t = recent.add<JsonObject>();
+        t["from"] = machine.stateName(trace[i].from);
+        t["to"] = machine.stateName(trace[i].to);
+        t["at_ms"] = trace[i].at_ms;
+        t["dwell_ms"] = trace[i].dwell_ms;
+        t["cause"] = trace[i].cause;
+    }
+}
+
+void StatusServer::handleState() {
+    StatusView snapshot;
+    copyView(snapshot);
+
+    JsonDocument doc;
+
+    Lifecycle& lifecycle = Lifecycle::getInstance();
+    writeMachine(doc["wifi"].to<JsonObject>(), lifecycle.wifi);
+    writeMachine(doc["spotify"].to<JsonObject>(), lifecycle.spotify);
+    writeMachine(doc["system"].to<JsonObject>(), lifecycle.system);
+
+    JsonObject n = doc["network"].to<JsonObject>();
+    n["ssid"] = networkState.wifi_connected ? WiFi.SSID() : String("");
+    n["ip"] = snapshot.ip;
+    n["connected"] = networkState.wifi_connected;
+    n["link_lost"] = networkState.link_lost;
+
+    JsonObject t = doc["track"].to<JsonObject>();
+    t["id"] = snapshot.track_id;
+    t["title"] = snapshot.track_title;
+    t["artist"] = snapshot.track_artist;
+    t["device"] = snapshot.track_device;
+    t["playing"] = snapshot.playing;
+    t["duration_ms"] = snapshot.duration_ms;
+    t["progress_ms"] = snapshot.playing
+        ? snapshot.progress_ms + (millis() - snapshot.progress_anchor_time)
+        : snapshot.progress_ms;
+
+    String body;
+    serializeJson(doc, body);
+    sendJson(200, body);
+}
+
+// --- Auth Callback ---
+void StatusServer::handleCallback() {
+    if (server.hasArg("code")) {
+        request_count++;
+        if (SpotifyManager::getInstance().receiveAuthCode(server.arg("code"))) {
+            server.send(200, "text/html", "<html><body><h2>Linked!</h2><p>You can close this page.</p></body></html>");
+        } else {
+            server.send(409, "text/html", "<html><body><h2>Not waiting for a code</h2></body></html>");
+        }
+        return;
+    }
+
+    if (server.hasArg("error")) {
+        request_count++;
+        Serial.printf("StatusServer: Auth callback error - %s\n", server.arg("error").c_str());
+        server.send(400, "text/html", "<html><body><h2>Spotify link cancelled</h2></body></html>");
+        return;
+    }
+
+    handleOther();
+}
+
+void StatusServer::handleOther() {
+    sendJson(404, "{\"error\":\"not found\",\"endpoints\":[\"/metrics\",\"/state\"]}");
+}
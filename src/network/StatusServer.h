@@ -0,0 +1,81 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef STATUSSERVER_H
+#define STATUSSERVER_H
+
+#include <Arduino.h>
+#include <WebServer.h>
+
+#include "network/HttpDownloader.h"
+#include "spotify/PlaybackParser.h"
+
+// Same port and path the auth proxy redirects the OAuth code to
+#define STATUS_SERVER_PORT 8888
+#define STATUS_SERVER_CALLBACK_PATH "/"
+#define STATUS_SERVER_POLL_MS 20        // Gap between handleClient() calls
+
+// Everything a handler needs that the system task owns, copied under the lock
+struct StatusView {
+    PollStats poll;
+    DownloadStats art_download;
+    String ip;
+    String track_id;
+    String track_title;
+    String track_artist;
+    String track_device;
+    bool playing = false;
+    int duration_ms = 0;
+    int progress_ms = 0;
+    uint32_t progress_anchor_time = 0;
+};
+
+// Local HTTP server on its own low priority task, so a slow client never holds
+// up the system task. Serves JSON metrics and state for dashboards, and takes the
+// Spotify OAuth callback on the same listener:
+//   GET /metrics       - poll, rate limit, art, frame, heap, WiFi and task numbers
+//   GET /state         - lifecycle states, recent transitions, network and track
+//   GET /?code=...     - Spotify auth code, only accepted while unlinked
+class StatusServer {
+public:
+    static StatusServer& getInstance() {
+        static StatusServer instance;
+        return instance;
+    }
+
+    // Spawns the server task - it starts listening once WiFi is up
+    void start();
+
+    // Called from the system task, copies what the handlers read
+    void publish();
+
+    uint32_t getRequestCount() const { return request_count; }
+
+private:
+    StatusServer() : server(STATUS_SERVER_PORT) { view_mutex = xSemaphoreCreateMutex(); }
+
+    WebServer server;
+    TaskHandle_t task = nullptr;
+    volatile uint32_t request_count = 0;
+
+    SemaphoreHandle_t view_mutex = nullptr;
+    StatusView view;
+
+    static void taskEntry(void* arg);
+    void run();
+    void begin();
+    void copyView(StatusView& out);
+    void handleCallback();
+    void handleMetrics();
+    void handleState();
+    void handleOther();     // 404
+    void sendJson(int code, const String& body);
+
+    StatusServer(const StatusServer&) = delete;
+    void operator=(const StatusServer&) = delete;
+};
+
+
+
+#endif //STATUSSERVER_H
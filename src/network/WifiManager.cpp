@@ -6,20 +6,57 @@
 
 #include <LittleFS.h>
 
+#include "system/BootSequencer.h"
+#include "system/Lifecycle.h"
 #include "system/SystemManager.h"
+#include "system/StateBus.h"
+#include "network/DnsCache.h"
 
 #include <WiFi.h>
+#include <lwip/dns.h>
+#include <algorithm>
 
 #include "global_state.h"
 #include "spotify/SpotifyManager.h"
 
+#define FAST_CONNECT_TIMEOUT_MS 3000
+#define FULL_CONNECT_TIMEOUT_MS 10000   // Scan, join and DHCP
+
+#define RECONNECT_BACKOFF_MIN_MS 500
+#define RECONNECT_BACKOFF_MAX_MS 30000
+#define RECONNECT_FAST_ATTEMPTS 2       // Channel-locked tries before a full scan
+
+#define SCAN_FIRST_CHANNEL 1
+#define SCAN_LAST_CHANNEL 13
+#define SCAN_DWELL_MS 100
+#define SCAN_CACHE_TTL_MS 60000
+#define SCAN_RETRY_MS 1000              // Driver busy - give it a moment
+#define SCAN_MAX_RETRIES 3              // Per channel, then the scan has failed
+
 void WifiManager::update() {
+    if (scan_retry_pending && (int32_t)(millis() - scan_retry_at) >= 0) {
+        scan_retry_pending = false;
+        if (scan_channel) scanChannel(scan_channel);
+    }
+
     if (networkState.status == WIFI_CONNECTING) {
         handleConnecting();
     }
+    else if (networkState.status == WIFI_CONNECTED && networkState.link_lost) {
+        handleLinkLoss();
+    }
+    else if (networkState.status == WIFI_CONNECTED && reassociated) {
+        reassociated = false;
+        onAssociated();
+    }
     else if (networkState.status == WIFI_SCANNING) {
         handleScanning();
     }
+    else if (networkState.status == WIFI_IDLE && !isScanning() &&
+             (last_scan_time == 0 || millis() - last_scan_time > SCAN_CACHE_TTL_MS)) {
+        // Onboarding screen is up - scan in the background so "Get Connected!" is instant
+        startScan();
+    }
 }
 
 
@@ -36,46 +73,174 @@ void WifiManager::requestConnect(uint32_t timeoutMs) {
     }
 }
 
+void WifiManager::beginConnect(uint32_t timeoutMs) {
+    ssid_to_connect = networkState.selected_ssid;
+    pass_to_connect = networkState.selected_pass;
+    connect_timeout = timeoutMs;
+
+    processConnect();
+}
+
 void WifiManager::processConnect() {
     Serial.println("WifiManager::processConnect");
-    networkState.status = WIFI_CONNECTING;
+    Lifecycle::getInstance().setWifi(WIFI_CONNECTING, "connect requested");
     Serial.printf("Connecting to %s...\n", ssid_to_connect.c_str());
 
-    WiFi.disconnect();
+    registerLinkEvents();
+
+    if (WiFi.status() == WL_CONNECTED) WiFi.disconnect();
     WiFi.mode(WIFI_STA);
-    WiFi.begin(ssid_to_connect.c_str(), pass_to_connect.c_str());
+    WiFi.setAutoReconnect(false); // Link monitor owns reconnects
 
+    const WifiLeaseCache& lease = networkState.lease;
     connect_start_time = millis();
+    startAssociation(lease.valid && lease.ssid == ssid_to_connect);
+}
+
+void WifiManager::startAssociation(bool fast) {
+    // A channel scan still hopping would fight the join for the radio
+    cancelScan();
+
+    fast_connect = fast;
+    attempt_start_time = millis();
+
+    // Always DHCP - the fast path only skips the scan
+    WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+
+    if (fast) {
+        // Channel-locked join straight to the last AP
+        const WifiLeaseCache& lease = networkState.lease;
+        Serial.printf("WiFi: Fast connect (ch %d)\n", lease.channel);
+        WiFi.begin(ssid_to_connect.c_str(), pass_to_connect.c_str(), lease.channel, lease.bssid, true);
+    } else {
+        // Full scan
+        WiFi.begin(ssid_to_connect.c_str(), pass_to_connect.c_str());
+    }
 }
 
 void WifiManager::handleConnecting() {
     if (WiFi.status() == WL_CONNECTED) {
-        networkState.status = WIFI_CONNECTED;
         networkState.wifi_connected = true;
+        networkState.link_lost = false;
+        StateBus::getInstance().publish(FIELD_LINK_LOST);
+        reconnect_attempts = 0;
+        next_reconnect_time = 0;
         networkState.ip = WiFi.localIP().toString();
+        Lifecycle::getInstance().setWifi(WIFI_CONNECTED, fast_connect ? "associated (fast)" : "associated");
+        BootSequencer::getInstance().mark(BOOT_MILESTONE_WIFI_CONNECTED);
 
-        IPAddress dns1(8, 8, 8, 8);
-        IPAddress dns2(4, 4, 4, 4);
-        WiFi.config(WiFi.localIP(), WiFi.gatewayIP(), WiFi.subnetMask(), dns1, dns2);
+        systemState.setup_complete = true;
+        onAssociated();
 
         Serial.printf("Device IP: %s\n", networkState.ip.c_str());
         Serial.printf("DNS 1: %s\n", WiFi.dnsIP(0).toString().c_str()); // Verify it took
-        Serial.println("WiFi connected and DNS configured");
+        Serial.printf("WiFi connected and DNS configured in %u ms (%s)\n",
+            millis() - connect_start_time, fast_connect ? "fast" : "full");
 
-        // Save config here
-        systemState.setup_complete = true;
-        SystemManager::getInstance().writeConfig();
+        // Wall clock for token expiry - SNTP runs in the background
+        configTime(0, 0, "pool.ntp.org", "time.google.com");
+
+    } else if (fast_connect && millis() - attempt_start_time > FAST_CONNECT_TIMEOUT_MS) {
+        // AP moved channel or BSSID - forget it and do it properly
+        Serial.println("WiFi: Fast connect failed, falling back to full scan");
+        networkState.lease.valid = false;
+        WiFi.disconnect();
+        startAssociation(false);
 
     } else if (millis() - connect_start_time > connect_timeout) {
         // Network timed out
-        networkState.status = WIFI_ERROR;
         networkState.wifi_connected = false;
+        Lifecycle::getInstance().setWifi(WIFI_ERROR, "connect timed out");
         WiFi.disconnect();
         Serial.println("WiFi Timeout!");
     }
 }
 
+// Shared by the first connect and the link monitor's reconnects, whichever path they took
+void WifiManager::onAssociated() {
+    networkState.ip = WiFi.localIP().toString();    // DHCP may have handed out a new one
+
+    // Swap the DNS servers in place - WiFi.config() here would restart the interface
+    ip_addr_t dns1, dns2;
+    IP_ADDR4(&dns1, 8, 8, 8, 8);
+    IP_ADDR4(&dns2, 4, 4, 4, 4);
+    dns_setserver(0, &dns1);
+    dns_setserver(1, &dns2);
+
+    // A full-scan reconnect may have landed on another AP
+    saveLease();
+    SystemManager::getInstance().writeConfig();
+
+    // Resolve the API and CDN hosts before the next poll needs them
+    DnsCache::getInstance().prewarm();
+}
+
+void WifiManager::saveLease() {
+    WifiLeaseCache& lease = networkState.lease;
+
+    lease.ssid = ssid_to_connect;
+    memcpy(lease.bssid, WiFi.BSSID(), sizeof(lease.bssid));
+    lease.channel = WiFi.channel();
+    lease.valid = true;
+}
+
+// --- Link Monitor ---
+void WifiManager::registerLinkEvents() {
+    if (link_events_registered) return;
+    link_events_registered = true;
+
+    // Runs on the WiFi event task - only flag it, the system task does the work
+    WiFi.onEvent([](arduino_event_id_t event, arduino_event_info_t info) {
+        if (networkState.status != WIFI_CONNECTED || networkState.link_lost) return;
+
+        networkState.link_lost = true;
+        StateBus::getInstance().publish(FIELD_LINK_LOST);
+        networkState.link_lost_time = millis();
+        networkState.wifi_connected = false;
+        Serial.printf("WiFi: Link lost (reason %d)\n", info.wifi_sta_disconnected.reason);
+    }, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+
+    WiFi.onEvent([](arduino_event_id_t event, arduino_event_info_t info) {
+        if (!networkState.link_lost) return;
+
+        networkState.last_reconnect_ms = millis() - networkState.link_lost_time;
+        networkState.reconnects++;
+        networkState.wifi_connected = true;
+        networkState.link_lost = false;
+        StateBus::getInstance().publish(FIELD_LINK_LOST);
+        getInstance().reconnect_attempts = 0;
+        getInstance().reassociated = true;
+        Serial.printf("WiFi: Link restored in %u ms\n", networkState.last_reconnect_ms);
+    }, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+}
+
+void WifiManager::handleLinkLoss() {
+    if ((int32_t)(millis() - next_reconnect_time) < 0) return;
+
+    // Fast channel-locked attempts first, then fall back to a full scan
+    bool fast = networkState.lease.valid && reconnect_attempts < RECONNECT_FAST_ATTEMPTS;
+    Serial.printf("WiFi: Reconnect attempt %u (%s)\n", reconnect_attempts + 1, fast ? "fast" : "full");
+
+    WiFi.disconnect();
+    startAssociation(fast);
+
+    uint32_t backoff = RECONNECT_BACKOFF_MIN_MS << min(reconnect_attempts, (uint32_t)6);
+    if (backoff > RECONNECT_BACKOFF_MAX_MS) backoff = RECONNECT_BACKOFF_MAX_MS;
+    // Never tear down an attempt that could still be associating
+    next_reconnect_time = millis() + backoff + (fast ? FAST_CONNECT_TIMEOUT_MS : FULL_CONNECT_TIMEOUT_MS);
+    reconnect_attempts++;
+}
+
 // --- Scanning ---
+static uint32_t hashSSID(const String& ssid) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < ssid.length(); i++) {
+        hash ^= (uint8_t)ssid[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 void WifiManager::requestScan() {
     if (systemTaskHandle != NULL) {
         xTaskNotify(systemTaskHandle, CMD_WIFI_SCAN, eSetBits);
@@ -85,35 +250,201 @@ void WifiManager::requestScan() {
 void WifiManager::processScan() {
     Serial.println("WiFi Scanning...");
 
-    WiFi.disconnect();
-    networkState.status = WIFI_SCANNING;
     networkState.wifi_connected = false;
 
+    // Show whatever the background scan already found, refresh behind it
+    xSemaphoreTake(scan_mutex, portMAX_DELAY);
+    bool have_cached = !networkState.found_networks.empty();
+    xSemaphoreGive(scan_mutex);
 
-    int n = WiFi.scanNetworks(false, false);
+    Lifecycle::getInstance().setWifi(have_cached ? WIFI_SCAN_RESULTS : WIFI_SCANNING, "scan requested");
 
-    networkState.found_ssids.clear();
-    for (int i = 0; i < n; ++i) {
-        String currentSSID = WiFi.SSID(i);
+    if (!isScanning()) startScan();
+}
 
+void WifiManager::handleScanning() {
 
-        bool exists = false;
-        for (const String& s : networkState.found_ssids) {
-            if (s == currentSSID) { exists = true; break; }
-        }
+}
 
-        if (!exists && currentSSID.length() > 0) {
-            networkState.found_ssids.push_back(currentSSID);
-        }
+void WifiManager::startScan() {
+    if (!scan_event_registered) {
+        WiFi.onEvent([](arduino_event_id_t event, arduino_event_info_t info) {
+            getInstance().onScanDone();
+        }, ARDUINO_EVENT_WIFI_SCAN_DONE);
+        scan_event_registered = true;
+    }
+
+    WiFi.mode(WIFI_STA);
+    if (WiFi.status() != WL_CONNECTED) WiFi.disconnect();
+
+    // Start from the cached set so the list doesn't empty out mid-scan
+    xSemaphoreTake(scan_mutex, portMAX_DELAY);
+    scan_working = networkState.found_networks;
+    scan_seen.assign(scan_working.size(), false);
+    scan_retries = 0;
+    scan_index.clear();
+    for (size_t i = 0; i < scan_working.size(); i++) {
+        scan_index[hashSSID(scan_working[i].ssid)] = i;
+    }
+    xSemaphoreGive(scan_mutex);
+
+    scanChannel(SCAN_FIRST_CHANNEL);
+}
+
+// The SCAN_DONE handler checks scan_channel under the lock, so nothing chains on after this
+void WifiManager::cancelScan() {
+    xSemaphoreTake(scan_mutex, portMAX_DELAY);
+    bool was_scanning = scan_channel != 0;
+    scan_channel = 0;
+    scan_retry_pending = false;
+    xSemaphoreGive(scan_mutex);
+
+    if (was_scanning) {
+        WiFi.scanDelete();
+        Serial.println("WiFi: Scan cancelled for a connect");
     }
+}
+
+void WifiManager::scanChannel(uint8_t channel) {
+    scan_channel = channel;
+    if (WiFi.scanNetworks(true, false, false, SCAN_DWELL_MS, channel) != WIFI_SCAN_FAILED) {
+        scan_retries = 0;
+        return;
+    }
+
+    Serial.printf("WiFi: Scan of channel %d failed to start\n", channel);
 
+    // Stays "scanning" while it waits, the SCAN_DONE handler never sees a channel that didn't start
+    if (scan_retries < SCAN_MAX_RETRIES) {
+        scan_retries++;
+        scan_retry_at = millis() + SCAN_RETRY_MS;
+        scan_retry_pending = true;
+        return;
+    }
+
+    scanFailed();
+}
+
+// Not a finished scan - the cached list stays as it was instead of being swept
+void WifiManager::scanFailed() {
+    scan_channel = 0;
+    scan_retries = 0;
+    last_scan_time = millis();
+
+    Serial.println("WiFi: Scan failed");
+    if (networkState.status == WIFI_SCANNING) {
+        Lifecycle::getInstance().setWifi(WIFI_ERROR, "scan failed");
+    }
+}
+
+// Runs on the WiFi event task each time a channel finishes
+void WifiManager::onScanDone() {
+    xSemaphoreTake(scan_mutex, portMAX_DELAY);
+    uint8_t channel = scan_channel;
+    if (channel == 0) {
+        // Cancelled for a connect
+        xSemaphoreGive(scan_mutex);
+        return;
+    }
+
+    int count = WiFi.scanComplete();
+    if (count > 0) mergeScanResults(count);
     WiFi.scanDelete();
-    networkState.status = WIFI_SCAN_RESULTS;
-    Serial.println("WiFi: Scan complete");
+
+    bool final = channel >= SCAN_LAST_CHANNEL;
+    if (final) {
+        scan_channel = 0;
+        last_scan_time = millis();
+    }
+    xSemaphoreGive(scan_mutex);
+
+    publishScanResults(final);
+    if (final) return;
+
+    // Only hop on if nothing cancelled the scan while the results went out
+    xSemaphoreTake(scan_mutex, portMAX_DELAY);
+    bool still_scanning = scan_channel == channel;
+    xSemaphoreGive(scan_mutex);
+    if (still_scanning) scanChannel(channel + 1);
 }
 
-void WifiManager::handleScanning() {
+void WifiManager::mergeScanResults(int count) {
+    for (int i = 0; i < count; ++i) {
+        String ssid = WiFi.SSID(i);
+        if (ssid.length() == 0) continue;
+
+        int32_t rssi = WiFi.RSSI(i);
+        uint32_t hash = hashSSID(ssid);
+
+        auto it = scan_index.find(hash);
+        size_t index = SIZE_MAX;
+
+        if (it != scan_index.end() && scan_working[it->second].ssid == ssid) {
+            index = it->second;
+        } else if (it != scan_index.end()) {
+            // Hash collision - rare enough to just search
+            for (size_t j = 0; j < scan_working.size(); j++) {
+                if (scan_working[j].ssid == ssid) { index = j; break; }
+            }
+        }
+
+        if (index == SIZE_MAX) {
+            index = scan_working.size();
+            scan_working.emplace_back();
+            scan_seen.push_back(false);
+            scan_working[index].ssid = ssid;
+            if (it == scan_index.end()) scan_index[hash] = index;
+        } else if (scan_seen[index] && rssi <= scan_working[index].rssi) {
+            // Already have a stronger BSSID for this network
+            continue;
+        }
+
+        WifiNetwork& net = scan_working[index];
+        net.rssi = rssi;
+        net.channel = WiFi.channel(i);
+        net.auth = WiFi.encryptionType(i);
+        memcpy(net.bssid, WiFi.BSSID(i), sizeof(net.bssid));
+        scan_seen[index] = true;
+    }
+}
+
+void WifiManager::publishScanResults(bool final) {
+    std::vector<WifiNetwork> sorted;
+
+    xSemaphoreTake(scan_mutex, portMAX_DELAY);
+    sorted.reserve(scan_working.size());
+    for (size_t i = 0; i < scan_working.size(); i++) {
+        // Networks from the last scan stay until this one has covered every channel
+        if (final && !scan_seen[i]) continue;
+        sorted.push_back(scan_working[i]);
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [](const WifiNetwork& a, const WifiNetwork& b) {
+        return a.rssi > b.rssi;
+    });
+
+    networkState.found_networks.swap(sorted);
+    networkState.scan_version++;
+    StateBus::getInstance().publish(FIELD_SCAN_RESULTS);
+    bool have_results = !networkState.found_networks.empty();
+    xSemaphoreGive(scan_mutex);
+
+    // First results in - swap the spinner for the list
+    if (networkState.status == WIFI_SCANNING && (have_results || final)) {
+        Lifecycle::getInstance().setWifi(WIFI_SCAN_RESULTS, "first results");
+    }
+
+    if (final) {
+        Serial.printf("WiFi: Scan complete - %d networks\n", (int)networkState.found_networks.size());
+    }
+}
 
+uint32_t WifiManager::getNetworks(std::vector<WifiNetwork> &out) {
+    xSemaphoreTake(scan_mutex, portMAX_DELAY);
+    out = networkState.found_networks;
+    uint32_t version = networkState.scan_version;
+    xSemaphoreGive(scan_mutex);
+    return version;
 }
 
 // --- Reset ---
@@ -132,8 +463,9 @@ void WifiManager::processReset() {
 
     networkState.selected_ssid = "";
     networkState.selected_pass = "";
+    networkState.lease = WifiLeaseCache();
     networkState.wifi_connected = false;
-    networkState.status = WIFI_IDLE; // Should trigger onboarding
+    Lifecycle::getInstance().setWifi(WIFI_IDLE, "reset"); // Should trigger onboarding
 
     Serial.println("WiFi Reset Complete");
 }
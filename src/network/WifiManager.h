@@ -6,6 +6,11 @@
 #define WIFIMANAGER_H
 
 #include <Arduino.h>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include "global_state.h"
 
 
 class WifiManager {
@@ -18,27 +23,63 @@ public:
     void update();
 
     void requestConnect(uint32_t timeoutMs = 15000);
+    void beginConnect(uint32_t timeoutMs = 15000); // Direct, for callers already off the UI task
     void processConnect();
 
     void requestScan();
     void processScan();
 
+    // Thread safe copy of the latest (possibly partial) scan results
+    uint32_t getNetworks(std::vector<WifiNetwork>& out);
+    bool isScanning() const { return scan_channel != 0; }
+
     void requestReset();
     void processReset();
 
 private:
 
-    WifiManager() {}
+    WifiManager() { scan_mutex = xSemaphoreCreateMutex(); }
 
     // Connection
     String ssid_to_connect;
     String pass_to_connect;
     uint32_t connect_timeout;
     uint32_t connect_start_time;
+    uint32_t attempt_start_time;
+    bool fast_connect = false;
+    void startAssociation(bool fast);
     void handleConnecting();
+    void onAssociated();    // Every join, first connect or reconnect
+    void saveLease();
+
+    // Link Monitor
+    bool link_events_registered = false;
+    uint32_t reconnect_attempts = 0;
+    uint32_t next_reconnect_time = 0;
+    volatile bool reassociated = false;     // Set from the WiFi event task
+    void registerLinkEvents();
+    void handleLinkLoss();
 
     // Scanning
+    SemaphoreHandle_t scan_mutex = nullptr;            // found_networks and the scan_working set
+    std::atomic<uint8_t> scan_channel{0};   // Channel being scanned, 0 when idle
+    bool scan_event_registered = false;
+    uint32_t last_scan_time = 0;
+    std::vector<WifiNetwork> scan_working;
+    std::vector<bool> scan_seen;
+    std::unordered_map<uint32_t, size_t> scan_index;  // SSID hash -> scan_working
+    std::atomic<bool> scan_retry_pending{false};      // A channel failed to start, update() retries it
+    uint32_t scan_retry_at = 0;
+    uint8_t scan_retries = 0;
+
     void handleScanning();
+    void startScan();
+    void scanChannel(uint8_t channel);
+    void scanFailed();
+    void cancelScan();
+    void onScanDone();
+    void mergeScanResults(int count);
+    void publishScanResults(bool final);
 
 
 
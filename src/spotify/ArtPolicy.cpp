@@ -0,0 +1,64 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "ArtPolicy.h"
+
+#define ART_EWMA_WEIGHT 0.3f
+#define ART_FIRST_PAINT_BUDGET_MS 600
+#define ART_BYTES_PER_PIXEL 0.25f   // Spotify's album JPEGs, roughly
+
+void ArtPolicy::recordDownload(const DownloadStats& stats) {
+    if (stats.bytes == 0 || stats.elapsed_ms == 0) return;
+
+    // Whole request time, so latency counts against small images too
+    float sample = (float)stats.bytes * 1000.0f / stats.elapsed_ms;
+    throughput = samples == 0 ? sample : throughput + ART_EWMA_WEIGHT * (sample - throughput);
+    samples++;
+}
+
+uint32_t ArtPolicy::estimateMs(uint16_t width) const {
+    if (samples == 0 || throughput <= 0) return 0;  // Nothing measured yet - assume it's quick
+    return (uint32_t)((float)width * width * ART_BYTES_PER_PIXEL * 1000.0f / throughput);
+}
+
+void ArtPolicy::choose(const ArtImage* images, uint8_t count, short target_size, int& first, int& upgrade) const {
+    first = count > 0 ? 0 : -1;
+    upgrade = -1;
+
+    // Best fit is the smallest image that still covers target_size, else the largest
+    int best = -1;
+    for (int i = 0; i < count; i++) {
+        uint16_t w = images[i].width;
+        if (w == 0) continue;
+        if (w >= target_size && (best < 0 || w < images[best].width)) best = i;
+    }
+    if (best < 0) {
+        for (int i = 0; i < count; i++) {
+            if (images[i].width && (best < 0 || images[i].width > images[best].width)) best = i;
+        }
+    }
+    if (best < 0) return;  // No widths, take Spotify's first
+
+    first = best;
+    if (estimateMs(images[best].width) <= ART_FIRST_PAINT_BUDGET_MS) return;
+
+    // Too slow for the full image - largest smaller one that fits the budget,
+    // or the smallest as a placeholder
+    int quick = -1;
+    for (int i = 0; i < count; i++) {
+        uint16_t w = images[i].width;
+        if (w == 0 || w >= images[best].width) continue;
+
+        bool fits = estimateMs(w) <= ART_FIRST_PAINT_BUDGET_MS;
+        if (quick < 0) { quick = i; continue; }
+
+        bool quick_fits = estimateMs(images[quick].width) <= ART_FIRST_PAINT_BUDGET_MS;
+        if (fits && (!quick_fits || w > images[quick].width)) quick = i;
+        else if (!fits && !quick_fits && w < images[quick].width) quick = i;
+    }
+    if (quick < 0) return;
+
+    first = quick;
+    upgrade = best;
+}
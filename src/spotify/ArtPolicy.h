@@ -0,0 +1,33 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef ARTPOLICY_H
+#define ARTPOLICY_H
+
+#include <Arduino.h>
+
+#include "PlaybackParser.h"
+#include "network/HttpDownloader.h"
+
+// Picks which album art size to fetch from how fast recent downloads were.
+// On a slow link a smaller image goes up first and the full one follows
+class ArtPolicy {
+public:
+    void recordDownload(const DownloadStats& stats);
+
+    // first is the image to show now, upgrade the one to fetch after it (-1 for none)
+    void choose(const ArtImage* images, uint8_t count, short target_size, int& first, int& upgrade) const;
+
+    uint32_t getThroughput() const { return (uint32_t)throughput; }
+
+private:
+    float throughput = 0;   // Bytes/s, EWMA
+    uint32_t samples = 0;
+
+    uint32_t estimateMs(uint16_t width) const;
+};
+
+
+
+#endif //ARTPOLICY_H
@@ -0,0 +1,199 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "PlaybackParser.h"
+
+#include <ArduinoJson.h>
+
+#include "Utf8.h"
+
+#define PARSE_ARENA_SIZE (8 * 1024)
+
+// Bump allocator over a static arena, reset before every parse.
+// The filtered document fits comfortably, so a normal poll never hits the heap -
+// anything that doesn't fit falls back to malloc and is counted
+class ArenaAllocator : public ArduinoJson::Allocator {
+public:
+    uint32_t heap_allocs = 0;
+    uint32_t heap_bytes = 0;
+    uint32_t high_water = 0;
+
+    void reset() {
+        used = 0;
+        last = nullptr;
+        heap_allocs = 0;
+        heap_bytes = 0;
+        high_water = 0;
+    }
+
+    void* allocate(size_t size) override {
+        size_t needed = align(size) + sizeof(size_t);
+
+        if (used + needed > PARSE_ARENA_SIZE) {
+            heap_allocs++;
+            heap_bytes += size;
+            return malloc(size);
+        }
+
+        // Block size is stored in front so reallocate() knows how much to copy
+        uint8_t* block = &arena[used];
+        *(size_t*)block = size;
+        used += needed;
+        if (used > high_water) high_water = used;
+
+        last = block + sizeof(size_t);
+        return last;
+    }
+
+    void deallocate(void* ptr) override {
+        if (!owns(ptr)) {
+            free(ptr);
+            return;
+        }
+
+        // Only the most recent block can be given back
+        if (ptr == last) {
+            used = (uint8_t*)ptr - arena - sizeof(size_t);
+            last = nullptr;
+        }
+    }
+
+    void* reallocate(void* ptr, size_t new_size) override {
+        if (!ptr) return allocate(new_size);
+
+        if (!owns(ptr)) {
+            heap_allocs++;
+            heap_bytes += new_size;
+            return realloc(ptr, new_size);
+        }
+
+        size_t* header = (size_t*)((uint8_t*)ptr - sizeof(size_t));
+        size_t old_size = *header;
+
+        // Grow or shrink the top block in place
+        if (ptr == last) {
+            size_t start = (uint8_t*)ptr - arena;
+            if (start + align(new_size) <= PARSE_ARENA_SIZE) {
+                *header = new_size;
+                used = start + align(new_size);
+                if (used > high_water) high_water = used;
+                return ptr;
+            }
+        } else if (new_size <= old_size) {
+            *header = new_size;
+            return ptr;
+        }
+
+        void* moved = allocate(new_size);
+        if (moved) memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+        deallocate(ptr);
+        return moved;
+    }
+
+private:
+    alignas(8) uint8_t arena[PARSE_ARENA_SIZE];
+    size_t used = 0;
+    void* last = nullptr;
+
+    static size_t align(size_t size) { return (size + 7) & ~size_t(7); }
+
+    bool owns(void* ptr) const {
+        return (uint8_t*)ptr >= arena && (uint8_t*)ptr < arena + PARSE_ARENA_SIZE;
+    }
+};
+
+static ArenaAllocator parse_allocator;
+
+// FNV-1a, folded over each field in turn
+static uint32_t fnv1a(uint32_t hash, const char* s) {
+    if (!s) return hash;
+    while (*s) {
+        hash ^= (uint8_t)*s++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Only these fields survive deserialisation - artist lists, markets, image
+// heights etc. are skipped by the tokenizer and never allocated
+static const JsonDocument& playbackFilter() {
+    static JsonDocument filter;
+    static bool built = false;
+
+    if (!built) {
+        filter["is_playing"] = true;
+        filter["progress_ms"] = true;
+        filter["currently_playing_type"] = true;
+        filter["device"]["id"] = true;
+        filter["device"]["name"] = true;
+        filter["item"]["id"] = true;
+        filter["item"]["name"] = true;
+        filter["item"]["duration_ms"] = true;
+        filter["item"]["artists"][0]["name"] = true;
+        filter["item"]["album"]["images"][0]["url"] = true;  // [0] applies to every element
+        filter["item"]["album"]["images"][0]["width"] = true;
+        built = true;
+    }
+
+    return filter;
+}
+
+static void copyField(char* dst, size_t dst_len, JsonVariantConst src) {
+    utf8Copy(dst, dst_len, src.as<const char*>());
+}
+
+bool PlaybackParser::parse(const char* body, size_t len, PlaybackSnapshot& out, PollStats& stats) {
+    uint32_t start = micros();
+    parse_allocator.reset();
+
+    bool ok = false;
+    {
+        JsonDocument doc(&parse_allocator);
+        DeserializationError error = deserializeJson(doc, body, len,
+            DeserializationOption::Filter(playbackFilter()));
+
+        if (error) {
+            Serial.printf("Spotify: Playback parse failed - %s\n", error.c_str());
+        } else {
+            out.has_playback = true;
+            out.is_playing = doc["is_playing"] | false;
+            out.progress_ms = doc["progress_ms"] | 0;
+            out.is_track = strcmp(doc["currently_playing_type"] | "", "track") == 0;
+            copyField(out.device_name, sizeof(out.device_name), doc["device"]["name"]);
+
+            JsonVariantConst item = doc["item"];
+            out.duration_ms = item["duration_ms"] | 0;
+            copyField(out.track_id, sizeof(out.track_id), item["id"]);
+            copyField(out.track_name, sizeof(out.track_name), item["name"]);
+            copyField(out.artist_name, sizeof(out.artist_name), item["artists"][0]["name"]);
+
+            out.art_count = 0;
+            for (JsonVariantConst image : item["album"]["images"].as<JsonArrayConst>()) {
+                if (out.art_count >= ART_MAX_IMAGES) break;
+                ArtImage& art = out.art[out.art_count++];
+                art.width = image["width"] | 0;
+                copyField(art.url, sizeof(art.url), image["url"]);
+            }
+
+            // Episodes and ads come through without an item
+            if (item.isNull()) out.is_track = false;
+
+            uint32_t hash = 2166136261u;
+            hash = fnv1a(hash, out.track_id);
+            hash = fnv1a(hash, out.is_playing ? "1" : "0");
+            hash = fnv1a(hash, doc["device"]["id"].as<const char*>());
+            out.fingerprint = hash;
+            ok = true;
+        }
+    } // doc freed here so the counts include the teardown
+
+    stats.last_parse_us = micros() - start;
+    if (stats.last_parse_us > stats.max_parse_us) stats.max_parse_us = stats.last_parse_us;
+    stats.last_allocs = parse_allocator.heap_allocs;
+    stats.last_alloc_bytes = parse_allocator.heap_bytes;
+    stats.total_allocs += parse_allocator.heap_allocs;
+    stats.last_arena_bytes = parse_allocator.high_water;
+
+    return ok;
+}
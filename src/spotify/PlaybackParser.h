@@ -0,0 +1,66 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef PLAYBACKPARSER_H
+#define PLAYBACKPARSER_H
+
+#include <Arduino.h>
+
+#define ART_MAX_IMAGES 3  // Spotify sends 640, 300 and 64px
+
+struct ArtImage {
+    uint16_t width = 0;     // 0 if Spotify didn't say
+    char url[128] = "";
+};
+
+// Compact copy of the fields we actually use from /v1/me/player
+// Fixed size so a poll never touches the heap once parsed
+struct PlaybackSnapshot {
+    bool has_playback = false;  // false on 204 (nothing playing)
+    bool is_playing = false;
+    bool is_track = false;      // false for episodes / ads
+
+    int32_t progress_ms = 0;
+    int32_t duration_ms = 0;
+
+    // Hash of track id, is_playing and device id - equal fingerprints mean
+    // only progress has moved since the last poll
+    uint32_t fingerprint = 0;
+
+    char device_name[64] = "";
+    char track_id[32] = "";     // Spotify IDs are 22 chars
+    char track_name[128] = "";
+    char artist_name[96] = "";
+
+    ArtImage art[ART_MAX_IMAGES];  // Largest first, as Spotify orders them
+    uint8_t art_count = 0;
+};
+
+// Published after every poll
+struct PollStats {
+    uint32_t polls = 0;
+    uint32_t failures = 0;
+
+    uint32_t last_request_ms = 0;   // Full round trip, headers + body
+    uint32_t last_body_bytes = 0;
+    uint32_t last_parse_us = 0;
+    uint32_t max_parse_us = 0;
+
+    uint32_t last_allocs = 0;       // Heap allocations made by the parser
+    uint32_t last_alloc_bytes = 0;
+    uint32_t total_allocs = 0;
+    uint32_t last_arena_bytes = 0;  // Served from the static parse arena
+
+    uint32_t unchanged_polls = 0;   // Polls that took the fast path
+};
+
+class PlaybackParser {
+public:
+    // Parses a /v1/me/player body into out, only keeping the filtered fields
+    static bool parse(const char* body, size_t len, PlaybackSnapshot& out, PollStats& stats);
+};
+
+
+
+#endif //PLAYBACKPARSER_H
@@ -0,0 +1,112 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "RateLimiter.h"
+
+#include "system/TraceLog.h"
+
+// Whole tokens each priority has to leave in the bucket
+static const uint32_t reserve[RATE_PRIORITY_COUNT] = { 0, RATE_POLL_RESERVE };
+
+void RateLimiter::refill(uint32_t now) {
+    if (blocked) {
+        // Nothing builds up during a Retry-After, so it doesn't end in a burst
+        if ((int32_t)(now - blocked_until) < 0) {
+            last_refill_ms = now;
+            return;
+        }
+        blocked = false;
+        last_refill_ms = blocked_until;
+        Serial.println("RateLimiter: Retry-After passed, resuming");
+    }
+
+    if (last_refill_ms == 0) last_refill_ms = now;
+
+    uint32_t elapsed = now - last_refill_ms;
+    last_refill_ms = now;
+
+    uint32_t add = (uint32_t)((uint64_t)elapsed * 1000 / RATE_REFILL_MS);
+    tokens_milli = min(tokens_milli + add, (uint32_t)RATE_BUCKET_SIZE * 1000);
+}
+
+uint32_t RateLimiter::waitMsLocked(RatePriority priority, uint32_t now) const {
+    if (blocked) return blocked_until - now;
+
+    uint32_t need = (reserve[priority] + 1) * 1000;
+    if (tokens_milli >= need) return 0;
+    return (uint32_t)((uint64_t)(need - tokens_milli) * RATE_REFILL_MS / 1000) + 1;
+}
+
+bool RateLimiter::acquire(RatePriority priority) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+
+    uint32_t now = millis();
+    refill(now);
+
+    uint32_t wait = waitMsLocked(priority, now);
+    if (wait == 0) {
+        tokens_milli -= 1000;
+        stats.granted[priority]++;
+    } else {
+        stats.deferred[priority]++;
+        TRACE(TRACE_RATE_DEFERRED, priority, wait);
+    }
+
+    xSemaphoreGive(mutex);
+    return wait == 0;
+}
+
+void RateLimiter::onResponse(int http_code, uint32_t retry_after_s) {
+    if (http_code != 429) return;   // HTTP_CODE_TOO_MANY_REQUESTS
+
+    uint32_t retry_ms = retry_after_s ? retry_after_s * 1000 : RATE_DEFAULT_RETRY_MS;
+    if (retry_ms > RATE_MAX_RETRY_MS) retry_ms = RATE_MAX_RETRY_MS;
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+
+    // Whatever we thought we had, Spotify disagrees
+    uint32_t now = millis();
+    tokens_milli = 0;
+    last_refill_ms = now;
+
+    // Overlapping 429s only ever push the wait out
+    uint32_t until = now + retry_ms;
+    if (!blocked || (int32_t)(until - blocked_until) > 0) blocked_until = until;
+    blocked = true;
+
+    stats.throttled++;
+    stats.last_retry_after_ms = retry_ms;
+
+    xSemaphoreGive(mutex);
+
+    TRACE(TRACE_RATE_THROTTLED, retry_ms);
+    Serial.printf("RateLimiter: 429, holding requests for %u ms\n", retry_ms);
+}
+
+uint32_t RateLimiter::waitMs(RatePriority priority) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint32_t now = millis();
+    refill(now);
+    uint32_t wait = waitMsLocked(priority, now);
+    xSemaphoreGive(mutex);
+    return wait;
+}
+
+bool RateLimiter::isThrottled() {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    refill(millis());
+    bool throttled = blocked;
+    xSemaphoreGive(mutex);
+    return throttled;
+}
+
+void RateLimiter::getStats(RateLimiterStats& out) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint32_t now = millis();
+    refill(now);
+    stats.blocked_ms = blocked ? blocked_until - now : 0;
+    stats.tokens = tokens_milli / 1000;
+    out = stats;
+    xSemaphoreGive(mutex);
+}
@@ -0,0 +1,75 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <Arduino.h>
+
+// Spotify's limit is a rolling 30 s window - this keeps us well inside it
+#define RATE_BUCKET_SIZE 8
+#define RATE_REFILL_MS 1500             // One request's worth of budget
+#define RATE_POLL_RESERVE 1             // Tokens a poll leaves behind for user actions
+#define RATE_DEFAULT_RETRY_MS 5000      // 429 without a Retry-After
+#define RATE_MAX_RETRY_MS 120000        // Ignore anything longer, the token would be stale
+
+enum RatePriority : uint8_t {
+    RATE_USER,      // Someone pressed something - waits only on Retry-After
+    RATE_POLL,      // Playback polling, token refresh
+    RATE_PRIORITY_COUNT
+};
+
+struct RateLimiterStats {
+    uint32_t granted[RATE_PRIORITY_COUNT] = {};
+    uint32_t deferred[RATE_PRIORITY_COUNT] = {};
+    uint32_t throttled = 0;             // 429s seen
+    uint32_t last_retry_after_ms = 0;
+    uint32_t blocked_ms = 0;            // Time left on the current Retry-After
+    uint32_t tokens = 0;                // Whole tokens left
+};
+
+// Token bucket shared by every Web API and accounts request. Album art comes off the
+// image CDN, which isn't part of the API's limit, so it isn't charged here. Polls have
+// to leave a reserve in the bucket, so polling never starves a button press. A 429
+// empties the bucket and holds everything until its Retry-After has passed.
+// Never blocks - a deferred request is retried by its caller
+class RateLimiter {
+public:
+    static RateLimiter& getInstance() {
+        static RateLimiter instance;
+        return instance;
+    }
+
+    // Takes a token if this priority may send now
+    bool acquire(RatePriority priority);
+
+    // Every response goes through here so a 429 is never missed
+    void onResponse(int http_code, uint32_t retry_after_s = 0);
+
+    // How long until acquire() would succeed, 0 if it would now
+    uint32_t waitMs(RatePriority priority);
+    bool isThrottled();     // Inside a Retry-After
+
+    void getStats(RateLimiterStats& out);
+
+private:
+    RateLimiter() { mutex = xSemaphoreCreateMutex(); }
+
+    SemaphoreHandle_t mutex = nullptr;
+    uint32_t tokens_milli = RATE_BUCKET_SIZE * 1000;  // Thousandths, refills smoothly
+    uint32_t last_refill_ms = 0;
+    uint32_t blocked_until = 0;
+    bool blocked = false;
+    RateLimiterStats stats;
+
+    void refill(uint32_t now);
+    uint32_t waitMsLocked(RatePriority priority, uint32_t now) const;
+
+    RateLimiter(const RateLimiter&) = delete;
+    void operator=(const RateLimiter&) = delete;
+};
+
+
+
+#endif //RATELIMITER_H
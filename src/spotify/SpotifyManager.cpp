@@ -6,9 +6,16 @@
 
 #include <HTTPClient.h>
 #include <WiFiClientSecure.h>
+#include <ArduinoJson.h>
+#include <time.h>
 
 #include "global_state.h"
+#include "RateLimiter.h"
+#include "system/Lifecycle.h"
+#include "system/StateBus.h"
+#include "system/TraceLog.h"
 #include "system/SystemManager.h"
+#include "system/Telemetry.h"
 #include "ui/UIManager.h"
 
 String sanitizeString(String str) {
@@ -30,6 +37,9 @@ void SpotifyManager::init() {
     }
 
     sp_auth = new Spotify::Auth(credentials);
+
+    // Downloads (and waits on the limiter for) album art so the polls never queue behind it
+    if (!art_task) xTaskCreatePinnedToCore(artTask, "ArtFetch", 8192, this, 1, &art_task, 0);
 }
 
 void SpotifyManager::update() {
@@ -48,14 +58,10 @@ void SpotifyManager::update() {
             break;
 
 
-        case SPOTIFY_NEED_LINK:
-            if (!isServerRunning) {
-                handleCodeWebServer();
-            }
-            break;
-
         case SPOTIFY_READY:
         {
+            scheduleTokenRefresh();
+
             static uint32_t lastPollTime = 0;
             uint32_t now = millis();
 
@@ -73,6 +79,9 @@ void SpotifyManager::update() {
 }
 
 void SpotifyManager::buildAuthURL() {
+    // The URL only depends on where the callback lands and who we are
+    String key = networkState.ip + "|" + spotifyState.client_id;
+    if (key == auth_url_key && spotifyState.auth_url.length() > 0) return;
 
     String proxyUrl = "https://spotify-proxy-6cuziwrfx-harry-skerritts-projects.vercel.app/api/callback";
     String localIP = networkState.ip.c_str();
@@ -92,56 +101,130 @@ void SpotifyManager::buildAuthURL() {
         scopes,
     std::string(localIP.c_str())
     ).c_str();
+
+    auth_url_key = key;
+    Serial.println("Spotify: Auth URL rebuilt");
+}
+
+
+
+// --- Token Refresh ---
+#define TOKEN_ENDPOINT "https://accounts.spotify.com/api/token"
+#define TOKEN_REFRESH_MARGIN_S 300      // Refresh 5 mins before expiry
+#define TOKEN_RETRY_MIN_MS 5000
+#define TOKEN_RETRY_MAX_MS 120000
+#define SPOTIFY_TOKEN_LIFETIME_S 3600   // Spotify always issues 1 hour tokens
+
+static bool clockValid() {
+    return time(nullptr) > 1700000000; // Set once SNTP has synced (survives a soft reset)
+}
+
+// millis() at which the current token should be refreshed in the background
+static uint32_t refreshDueFromExpiry() {
+    if (!clockValid() || spotifyState.access_token_expiry == 0) return millis();
+
+    int32_t remaining = (int32_t)(spotifyState.access_token_expiry - (uint32_t)time(nullptr)) - TOKEN_REFRESH_MARGIN_S;
+    if (remaining <= 0) return millis();
+    return millis() + (uint32_t)remaining * 1000;
 }
 
+static bool accessTokenExpired() {
+    if (spotifyState.access_token.length() == 0) return true;
+
+    if (clockValid() && spotifyState.access_token_expiry != 0) {
+        return (uint32_t)time(nullptr) + 60 >= spotifyState.access_token_expiry;
+    }
+
+    // No wall clock - a token from this boot can still be aged by millis()
+    if (spotifyState.access_token_issued_ms != 0) {
+        return millis() - spotifyState.access_token_issued_ms + 60000 >= SPOTIFY_TOKEN_LIFETIME_S * 1000UL;
+    }
 
+    // Restored from flash with no way to tell its age - one refresh is cheaper than a stale token
+    return true;
+}
 
 void SpotifyManager::handleRefreshValidation() {
-    Serial.println("Spotify: Attempting to refresh saved token...");
+    // Warm boot - the saved access token is still good, go straight to polling
+    if (!accessTokenExpired()) {
+        Serial.println("Spotify: Resuming with saved access token");
+        updateBearer();
+        token_refresh_due = refreshDueFromExpiry();
+        Lifecycle::getInstance().setSpotify(SPOTIFY_READY, "saved access token");
+        return;
+    }
 
-    if (sp_auth->begin(spotifyState.refresh_token.c_str())) {
+    // Someone is watching the loading screen - but not inside a Retry-After
+    if (!RateLimiter::getInstance().acquire(RATE_USER)) return;
 
-        sp_client = new Spotify::Client(*sp_auth);
+    Serial.println("Spotify: Attempting to refresh saved token...");
 
-        spotifyState.refresh_token = sp_auth->getRefreshToken().c_str();
+    TokenRefreshResult result;
+    if (requestAccessToken(spotifyState.client_id, spotifyState.client_secret, spotifyState.refresh_token, result)) {
+        applyTokenResult(result);
         Serial.println("Spotify: Refresh successful!");
-        spotifyState.status = SPOTIFY_READY;
+        Lifecycle::getInstance().setSpotify(SPOTIFY_READY, "token refreshed");
+    } else if (result.throttled) {
+        // Not a verdict on the token - stay here and try again once the limiter allows
+        Serial.println("Spotify: Token refresh rate limited, waiting");
     } else {
         Serial.println("Spotify: Refresh failed (Token expired or revoked)");
-        spotifyState.status = SPOTIFY_LINK_ERROR;
+        Lifecycle::getInstance().setSpotify(SPOTIFY_LINK_ERROR, "refresh rejected");
     }
 }
 
+// Called every system tick while READY - kicks off a refresh ahead of expiry
+// and picks up the result once the refresh task has finished
+void SpotifyManager::scheduleTokenRefresh() {
+    if (token_refresh_ready.load(std::memory_order_acquire)) {
+        TokenRefreshResult result = pending_refresh;
+        token_refresh_ready.store(false, std::memory_order_release);
+
+        if (result.ok) {
+            applyTokenResult(result);
+            token_retry_delay = 0;
+            Serial.println("Spotify: Background token refresh complete");
+        } else if (result.revoked) {
+            Serial.println("Spotify: Refresh token revoked");
+            Lifecycle::getInstance().setSpotify(SPOTIFY_LINK_ERROR, "refresh token revoked");
+        } else {
+            // Network blip - back off and keep using the current token
+            token_retry_delay = token_retry_delay ? min(token_retry_delay * 2, (uint32_t)TOKEN_RETRY_MAX_MS) : TOKEN_RETRY_MIN_MS;
+            token_refresh_due = millis() + token_retry_delay;
+            Serial.printf("Spotify: Background token refresh failed, retrying in %u ms\n", token_retry_delay);
+        }
+    }
+
+    if (!token_refresh_running && (int32_t)(millis() - token_refresh_due) >= 0 &&
+        RateLimiter::getInstance().acquire(RATE_POLL)) {
+        startTokenRefresh();
+    }
+}
 
+void SpotifyManager::startTokenRefresh() {
+    token_refresh_running = true;
 
-void SpotifyManager::handleCodeWebServer() {
-    isServerRunning = true;
+    // The task only reads these copies - nothing touches them again until it's finished
+    refresh_client_id = spotifyState.client_id;
+    refresh_client_secret = spotifyState.client_secret;
+    refresh_token_copy = spotifyState.refresh_token;
 
+    // Runs off the system task so a slow token endpoint never delays a poll
     xTaskCreatePinnedToCore(
         [](void* pvParameters) {
             SpotifyManager* manager = (SpotifyManager*)pvParameters;
 
-            Serial.println("Spotify: Auth Server Task Started");
-            String url = "http://" + networkState.ip;
-
-            std::string code = Spotify::AuthServer::waitForCode(
-                url.c_str(),
-                8888
-            );
-
-            if (!code.empty()) {
-                Serial.println("Spotify: Code received! Authing...");
-                manager->temp_auth_code = code;
-                spotifyState.status = SPOTIFY_AUTHENTICATING;
-            } else {
-                Serial.print("Spotify: Auth Server times out of failed to get code.");
-            }
+            TokenRefreshResult result;
+            requestAccessToken(manager->refresh_client_id, manager->refresh_client_secret,
+                               manager->refresh_token_copy, result);
 
-            manager->isServerRunning = false;
-            Serial.println("Spotify: Auth Server Task Finished and Deleting");
+            manager->pending_refresh = result;
+            manager->token_refresh_ready.store(true, std::memory_order_release);
+            manager->token_refresh_running = false;
+            Telemetry::getInstance().taskFinished();
             vTaskDelete(NULL);
         },
-        "SpotAuth",
+        "SpotToken",
         8192,
         this,
         1,
@@ -150,7 +233,77 @@ void SpotifyManager::handleCodeWebServer() {
     );
 }
 
+void SpotifyManager::applyTokenResult(const TokenRefreshResult &result) {
+    spotifyState.access_token = result.access_token;
+    spotifyState.access_token_expiry = clockValid() ? (uint32_t)time(nullptr) + result.expires_in : 0;
+    spotifyState.access_token_issued_ms = millis() ? millis() : 1;
+    if (result.refresh_token.length() > 0) spotifyState.refresh_token = result.refresh_token;
+
+    updateBearer();
+    SystemManager::getInstance().writeSpotifyTokens();
+
+    uint32_t lifetime = result.expires_in > TOKEN_REFRESH_MARGIN_S ? result.expires_in - TOKEN_REFRESH_MARGIN_S : 0;
+    token_refresh_due = millis() + lifetime * 1000;
+}
+
+bool SpotifyManager::requestAccessToken(const String &client_id, const String &client_secret,
+                                        const String &refresh_token, TokenRefreshResult &result) {
+    CachedSecureClient client;
+    client.setInsecure();
+    HTTPClient http;
+    http.setUserAgent("ESP32-Spotify-Mate");
+
+    if (!http.begin(client, TOKEN_ENDPOINT)) return false;
+
+    http.setAuthorization(client_id.c_str(), client_secret.c_str());
+    http.addHeader("Content-Type", "application/x-www-form-urlencoded");
+
+    const char* headers[] = { "Retry-After" };
+    http.collectHeaders(headers, 1);
+
+    int httpCode = http.POST("grant_type=refresh_token&refresh_token=" + refresh_token);
+    RateLimiter::getInstance().onResponse(httpCode, http.header("Retry-After").toInt());
+
+    if (httpCode == HTTP_CODE_OK) {
+        JsonDocument doc;
+        if (!deserializeJson(doc, http.getString())) {
+            result.access_token = doc["access_token"] | "";
+            result.refresh_token = doc["refresh_token"] | "";
+            result.expires_in = doc["expires_in"] | SPOTIFY_TOKEN_LIFETIME_S;
+            result.ok = result.access_token.length() > 0;
+        }
+    } else if (httpCode == HTTP_CODE_BAD_REQUEST || httpCode == HTTP_CODE_UNAUTHORIZED) {
+        result.revoked = true;
+    } else if (httpCode == HTTP_CODE_TOO_MANY_REQUESTS) {
+        result.throttled = true;
+    }
+
+    http.end();
+
+    if (!result.ok) Serial.printf("Spotify: Token endpoint returned %d\n", httpCode);
+    return result.ok;
+}
+
+
+
+bool SpotifyManager::receiveAuthCode(const String& code) {
+    // Runs on the StatusServer task - only take a code while linking. The code is
+    // stored before the transition, and the system task only reads it once it sees
+    // AUTHENTICATING through the lifecycle lock
+    if (code.length() == 0 || !Lifecycle::getInstance().spotify.isIn(SPOTIFY_STATE_UNLINKED)) {
+        Serial.println("Spotify: Ignoring auth code, not linking");
+        return false;
+    }
+
+    Serial.println("Spotify: Code received! Authing...");
+    temp_auth_code = code.c_str();
+    return Lifecycle::getInstance().setSpotify(SPOTIFY_AUTHENTICATING, "auth code received");
+}
+
 void SpotifyManager::handleAuthCodeExchange() {
+    // Stays AUTHENTICATING until the limiter lets it through
+    if (!RateLimiter::getInstance().acquire(RATE_USER)) return;
+
     Serial.println("Spotify: Exchanging code for tokens...");
 
     try {
@@ -158,179 +311,416 @@ void SpotifyManager::handleAuthCodeExchange() {
         sp_client = new Spotify::Client(*sp_auth);
 
         // Successful Exchange
-        spotifyState.refresh_token = sp_auth->getRefreshToken().c_str();
+        TokenRefreshResult result;
+        result.access_token = sp_auth->getAccessToken().c_str();
+        result.refresh_token = sp_auth->getRefreshToken().c_str();
+        result.expires_in = SPOTIFY_TOKEN_LIFETIME_S;
+        applyTokenResult(result); // Also writes tokens.json
 
-        SystemManager::getInstance().writeSpotifyTokens();
         systemState.spotify_linked = true;
         SystemManager::getInstance().writeConfig();
 
 
 
-        spotifyState.status = SPOTIFY_READY;
+        Lifecycle::getInstance().setSpotify(SPOTIFY_READY, "code exchanged");
         Serial.println("Spotify: Login Successful!");
     } catch (Spotify::Exception& e) {
         Serial.println("Spotify: Login Failed!");
         Serial.println(e.what());
-        spotifyState.status = SPOTIFY_ERROR;
+        Lifecycle::getInstance().setSpotify(SPOTIFY_ERROR, "code exchange failed");
     }
 
 }
 
-void SpotifyManager::loadAlbumArt(String &url, short target_size) {
-    WiFiClientSecure client;
-    client.setInsecure();
-    HTTPClient http;
-    http.setUserAgent("ESP32-Spotify-Mate");
+// --- Album Art ---
+#define ART_MIN_RECHECK_MS 250          // Floor on the art task's wait while something is owed
+#define ART_OFFLINE_RECHECK_MS 1000
+// Called from the UI - the download itself happens on the art task
+void SpotifyManager::requestAlbumArt(const String &url, short target_size) {
+    xSemaphoreTake(art_mutex, portMAX_DELAY);
+    art_job_url = url;
+    art_job_size = target_size;
+    art_job_pending = true;
+    xSemaphoreGive(art_mutex);
+
+    if (art_task != NULL) {
+        xTaskNotifyGive(art_task);
+    }
+}
 
-    if (http.begin(client, url)) {
-        int httpCode = http.GET();
-        if (httpCode == HTTP_CODE_OK) {
-            int len = http.getSize();
-            if (len <= 0) return;
-
-            uint8_t* temp_jpg = (uint8_t*)ps_malloc(len);
-            if (!temp_jpg) return;
-
-            WiFiClient* stream = http.getStreamPtr();
-            int downloaded = 0;
-            unsigned long timeout = millis();
-
-            // Loop until we have all the bytes or hit a timeout (5 seconds)
-            while (http.connected() && downloaded < len && (millis() - timeout < 5000)) {
-                size_t size = stream->available();
-                if (size) {
-                    int c = stream->readBytes(&temp_jpg[downloaded], size);
-                    downloaded += c;
-                    timeout = millis(); // Reset timeout on successful read
-                }
-                delay(1); // Let the network stack breathe
-            }
+DownloadStats SpotifyManager::getArtDownloadStats() {
+    xSemaphoreTake(art_mutex, portMAX_DELAY);
+    DownloadStats stats = art_stats;
+    xSemaphoreGive(art_mutex);
+    return stats;
+}
 
-            Serial.printf("Spotify: Downloaded %d of %d bytes\n", downloaded, len);
+bool SpotifyManager::takeAlbumArt(uint8_t *&data, size_t &len, short &target_size, String &request_url) {
+    xSemaphoreTake(art_mutex, portMAX_DELAY);
+    data = art_ready;
+    len = art_ready_len;
+    target_size = art_ready_size;
+    request_url = art_ready_request;
+    art_ready = nullptr;
+    xSemaphoreGive(art_mutex);
 
-            if (downloaded == len) {
-                // Only pass to UI if we have 100% of the file
-                UIManager::getInstance().updateAlbumArt(temp_jpg, len, target_size);
-            } else {
-                Serial.println("Spotify: Download incomplete, discarding buffer");
-                free(temp_jpg);
-            }
+    return data != nullptr;
+}
+
+// Sleeps until a request comes in, or until the limiter will let an owed one through
+void SpotifyManager::artTask(void* pvParameters) {
+    SpotifyManager* manager = (SpotifyManager*)pvParameters;
+    uint32_t wait_ms = 0;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, wait_ms ? pdMS_TO_TICKS(wait_ms) : portMAX_DELAY);
+        wait_ms = manager->processAlbumArt();
+    }
+}
+
+// Art comes off the image CDN (or GitHub for the built-in assets), not the Web API,
+// so it isn't charged to the RateLimiter - a 429 from the CDN only holds art
+uint32_t SpotifyManager::processAlbumArt() {
+    // Nothing goes out until WiFi is back, the request stays queued
+    if (!networkState.wifi_connected) return ART_OFFLINE_RECHECK_MS;
+
+    uint32_t now = millis();
+    if (art_held && (int32_t)(art_hold_until - now) > 0) return art_hold_until - now;
+    art_held = false;
+
+    xSemaphoreTake(art_mutex, portMAX_DELAY);
+    bool pending = art_job_pending;
+    xSemaphoreGive(art_mutex);
+
+    if (!pending) {
+        if (!art_upgrade_url.length()) return 0;
+
+        // Nothing new asked for - finish off the full size image
+        String upgrade = art_upgrade_url;
+        art_upgrade_url = "";
+        Serial.println("Spotify: Upgrading album art");
+        if (loadAlbumArt(upgrade, art_upgrade_size, art_upgrade_request) || !art_held) return 0;
+
+        art_upgrade_url = upgrade;     // Held by the CDN - still owed
+        return ART_MIN_RECHECK_MS;
+    }
+
+    xSemaphoreTake(art_mutex, portMAX_DELAY);
+    String url = art_job_url;
+    short target_size = art_job_size;
+    art_job_pending = false;
+    memcpy(art_images, art_images_shared, sizeof(art_images));
+    art_image_count = art_image_count_shared;
+    xSemaphoreGive(art_mutex);
+
+    // A new request replaces any upgrade still owed for the last one
+    art_upgrade_url = "";
+
+    // Only the current album has a choice of sizes
+    bool known = false;
+    for (int i = 0; i < art_image_count; i++) {
+        if (url == art_images[i].url) known = true;
+    }
+    if (!known) {
+        if (!loadAlbumArt(url, target_size, url)) return requeueAlbumArt(url, target_size);
+        return 0;
+    }
+
+    int first, upgrade;
+    art_policy.choose(art_images, art_image_count, target_size, first, upgrade);
+    Serial.printf("Spotify: Art %upx first%s (link ~%u KB/s)\n",
+        art_images[first].width, upgrade >= 0 ? ", upgrading later" : "", art_policy.getThroughput() / 1024);
+
+    if (!loadAlbumArt(art_images[first].url, target_size, url)) return requeueAlbumArt(url, target_size);
+
+    // The upgrade runs on a later pass so a newer request can still jump ahead of it
+    if (upgrade >= 0) {
+        art_upgrade_url = art_images[upgrade].url;
+        art_upgrade_request = url;
+        art_upgrade_size = target_size;
+        return ART_MIN_RECHECK_MS;
+    }
+    return 0;
+}
+
+// A job the CDN turned away goes back in the queue, unless something newer took its place
+uint32_t SpotifyManager::requeueAlbumArt(const String &url, short target_size) {
+    if (!art_held) return 0;
+
+    xSemaphoreTake(art_mutex, portMAX_DELAY);
+    if (!art_job_pending) {
+        art_job_url = url;
+        art_job_size = target_size;
+        art_job_pending = true;
+    }
+    xSemaphoreGive(art_mutex);
+    return ART_MIN_RECHECK_MS;
+}
+
+bool SpotifyManager::loadAlbumArt(const String &url, short target_size, const String &request_url) {
+    DownloadResult art;
+    bool ok = art_downloader.fetch(url, art);
+    art_policy.recordDownload(art.stats);
+
+    if (art.http_code == HTTP_CODE_TOO_MANY_REQUESTS) {
+        uint32_t hold_ms = art.retry_after_s ? art.retry_after_s * 1000 : RATE_DEFAULT_RETRY_MS;
+        if (hold_ms > RATE_MAX_RETRY_MS) hold_ms = RATE_MAX_RETRY_MS;
+        art_hold_until = millis() + hold_ms;
+        art_held = true;
+        Serial.printf("Spotify: Art CDN 429, holding art for %u ms\n", hold_ms);
+    }
+
+    xSemaphoreTake(art_mutex, portMAX_DELAY);
+    art_stats = art.stats;
+    xSemaphoreGive(art_mutex);
+
+    if (!ok) return false;
+
+    // Hand over to the graphics task, dropping anything it hasn't picked up yet
+    xSemaphoreTake(art_mutex, portMAX_DELAY);
+    free(art_ready);
+    art_ready = art.data;
+    art_ready_len = art.len;
+    art_ready_size = target_size;
+    art_ready_request = request_url;
+    xSemaphoreGive(art_mutex);
+    StateBus::getInstance().publish(FIELD_ART_READY);
+
+    return true;
+}
+
+
+// --- Lean Polling ---
+#define PLAYBACK_URL "https://api.spotify.com/v1/me/player?market=from_token"
+#define PLAYBACK_BODY_MAX (12 * 1024)
+#define POLL_STATS_LOG_INTERVAL 30
+
+// Fixed buffer the HTTP body is written into, avoids getString()
+class BodyBuffer : public Stream {
+public:
+    char* data = nullptr;
+    size_t capacity = 0;
+    size_t len = 0;
+    bool overflow = false;
+
+    bool reserve(size_t size) {
+        if (data) return true;
+        data = (char*)ps_malloc(size);
+        capacity = data ? size : 0;
+        return data != nullptr;
+    }
+
+    void clear() { len = 0; overflow = false; }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size) override {
+        if (len + size > capacity) {
+            overflow = true;
+            return 0;
         }
-        http.end();
+        memcpy(&data[len], buf, size);
+        len += size;
+        return size;
     }
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+static BodyBuffer playback_body;
+
+int SpotifyManager::fetchPlaybackState(PlaybackSnapshot& out) {
+    if (!playback_body.reserve(PLAYBACK_BODY_MAX)) return -1;
+    playback_body.clear();
+
+    uint32_t start = millis();
+
+    api_client.setInsecure();
+    api_http.setReuse(true);
+    api_http.setUserAgent("ESP32-Spotify-Mate");
+
+    if (!api_http.begin(api_client, PLAYBACK_URL)) return -1;
+
+    api_http.addHeader("Authorization", api_bearer);
+
+    const char* headers[] = { "Retry-After" };
+    api_http.collectHeaders(headers, 1);
+
+    int httpCode = api_http.GET();
+    RateLimiter::getInstance().onResponse(httpCode, api_http.header("Retry-After").toInt());
+
+    if (httpCode == HTTP_CODE_OK) {
+        int written = api_http.writeToStream(&playback_body);
+        if (written < 0 || playback_body.overflow) {
+            Serial.printf("Spotify: Playback body unreadable (%d)\n", written);
+            httpCode = -1;
+        } else if (!PlaybackParser::parse(playback_body.data, playback_body.len, out, poll_stats)) {
+            httpCode = -1;
+        }
+    } else if (httpCode == HTTP_CODE_NO_CONTENT) {
+        out.has_playback = false;
+    }
+
+    api_http.end();
+
+    // Connection is dead (e.g. the link dropped) - don't try to reuse it
+    if (httpCode < 0) api_client.stop();
+
+    poll_stats.polls++;
+    poll_stats.last_request_ms = millis() - start;
+    poll_stats.last_body_bytes = playback_body.len;
+    TRACE(TRACE_POLL, httpCode, poll_stats.last_request_ms);
+
+    if (poll_stats.polls % POLL_STATS_LOG_INTERVAL == 0) {
+        Serial.printf("Spotify: Poll stats - %u polls (%u unchanged), %u ms req, %u B body, parse %u us (max %u), %u heap allocs, %u B arena\n",
+            poll_stats.polls, poll_stats.unchanged_polls, poll_stats.last_request_ms, poll_stats.last_body_bytes,
+            poll_stats.last_parse_us, poll_stats.max_parse_us,
+            poll_stats.last_allocs, poll_stats.last_arena_bytes);
+    }
+
+    return httpCode;
 }
 
+// Header is cached so a poll doesn't rebuild it from the token every time
+void SpotifyManager::updateBearer() {
+    api_bearer = "Bearer ";
+    api_bearer += spotifyState.access_token;
+}
 
 bool SpotifyManager::getCurrentlyPlaying() {
-    if (sp_client == nullptr) return false;
+    if (api_bearer.length() == 0) return false;
 
-   // Serial.println("Spotify: Polling...");
+    // Over budget or inside a Retry-After - the progress bar keeps extrapolating meanwhile
+    if (!RateLimiter::getInstance().acquire(RATE_POLL)) return false;
 
-    try {
-        auto pb = sp_client->player().getPlaybackState();
-
-        if (pb.has_value()) {
-            spotifyState.current_track_device_name = sanitizeString(pb->device.name.c_str());
-            spotifyState.current_track_progress_ms = pb->progress_ms;
-            spotifyState.is_playing = pb->is_playing;
-
-            if (spotifyState.is_playing) {
-                if (systemState.status != SYSTEM_STATUS_ACTIVE) {
-                    if (systemState.status == SYSTEM_STATUS_SLEEP) {
-                        Serial.println("SLEEP DEBUG: PLAYBACK RESUMED WAKING HARDWARE");
-                        SystemManager::getInstance().exitSleepMode();
-                    }
-                    Serial.println("SLEEP DEBUG: PLAYBACK RESUMED ENTERING ACTIVE STATE");
-                    systemState.status = SYSTEM_STATUS_ACTIVE;
+    int httpCode = fetchPlaybackState(snapshot);
 
-                }
-            } else {
-                // Paused
-                if (systemState.status == SYSTEM_STATUS_ACTIVE) {
-                    Serial.println("SLEEP DEBUG: PLAYBACK PAUSED ENTERING IDLE STATE");
-                    systemState.status = SYSTEM_STATUS_IDLE;
-                    systemState.time_first_np = millis();
-                }
-            }
+    if (httpCode == HTTP_CODE_UNAUTHORIZED) {
+        // Access token expired early - refresh in the background and pick it up on a later poll
+        TRACE(TRACE_POLL_TOKEN_REJECTED);
+        token_refresh_due = millis();
+        return false;
+    }
 
+    if (httpCode < 0 || httpCode >= HTTP_CODE_INTERNAL_SERVER_ERROR) {
+        // Transport failure or Spotify having a moment - keep the player up and
+        // try again next poll. Actual link loss is picked up by the WiFi link monitor
+        poll_stats.failures++;
+        TRACE(TRACE_POLL_RETRY, httpCode);
+        return false;
+    }
+
+    if (httpCode == HTTP_CODE_TOO_MANY_REQUESTS) {
+        // Rate limited - not an error, the limiter holds the next poll until Retry-After
+        poll_stats.failures++;
+        return false;
+    }
+
+    if (httpCode != HTTP_CODE_OK && httpCode != HTTP_CODE_NO_CONTENT) {
+        poll_stats.failures++;
+        TRACE(TRACE_POLL_ERROR, httpCode);
+        Lifecycle::getInstance().setSpotify(SPOTIFY_ERROR, "poll failed");
+        return false;
+    }
 
-            auto track = pb->asTrack();
-            if (track) {
-                String newId = sanitizeString(track->id.c_str());
-                String newUrl = track->album.images.at(0).url.c_str();
-
-                bool trackChanged = (spotifyState.current_track_id != newId);
-                bool urlChanged = (spotifyState.current_track_url != newUrl);
-
-                if (trackChanged || urlChanged) {
-                    Serial.println("Spotify: Change detected...");
-                    spotifyState.current_track_id = newId;
-                    spotifyState.current_track_title = sanitizeString(track->name.c_str());
-                    spotifyState.current_track_artist = sanitizeString(track->artists.at(0).name.c_str());
-                    spotifyState.current_track_duration_ms = track->duration_ms; // Total length
-
-                    if (urlChanged) {
-                        Serial.println("Spotify: New Album Art detected...");
-                        try {
-                            Spotify::Extensions::VibrantPalette palette =
-                                Spotify::Extensions::VisualAPI().getVibrantImagePalette(newUrl.c_str());
-
-                            spotifyState.album_background_cover = calculateSmartBackground(palette);
-                        } catch (...) {
-                            Serial.println("Spotify: Image Palette Error - Couldn't get colour");
-                            spotifyState.album_background_cover = 0x191414; // Fallback
-                        }
-                        spotifyState.current_track_url = newUrl;
-                        spotifyState.needs_art_update = true;
-                        spotifyState.needs_text_update = false;
-                    } else {
-                        spotifyState.needs_text_update = true;
-                    }
+    // Same track, device and play state as last time - only progress moved
+    if (snapshot.has_playback && snapshot.fingerprint == last_fingerprint) {
+        spotifyState.setProgress(snapshot.progress_ms, millis());
+        poll_stats.unchanged_polls++;
+        return true;
+    }
+    last_fingerprint = snapshot.has_playback ? snapshot.fingerprint : 0;
+
+    if (snapshot.has_playback) {
+        String device_name = sanitizeString(snapshot.device_name);
+        if (device_name != spotifyState.current_track_device_name) {
+            spotifyState.current_track_device_name = device_name;
+            StateBus::getInstance().publish(FIELD_DEVICE_NAME);
+        }
+        spotifyState.setProgress(snapshot.progress_ms, millis());
+        spotifyState.is_playing = snapshot.is_playing;
+        spotifyState.has_playback = true;
+
+        if (spotifyState.is_playing) {
+            // Leaving SLEEP wakes the hardware
+            Lifecycle::getInstance().setSystem(SYSTEM_STATUS_ACTIVE, "playback resumed");
+        } else if (systemState.status == SYSTEM_STATUS_ACTIVE) {
+            // Entering IDLE starts the sleep timer
+            Lifecycle::getInstance().setSystem(SYSTEM_STATUS_IDLE, "playback paused");
+        }
+
+
+        if (snapshot.is_track) {
+            String newId = sanitizeString(snapshot.track_id);
+            String newUrl = snapshot.art_count ? snapshot.art[0].url : "";  // Largest identifies the album
+
+            bool trackChanged = (spotifyState.current_track_id != newId);
+            bool urlChanged = (spotifyState.current_track_url != newUrl);
+
+            if (trackChanged || urlChanged) {
+                spotifyState.current_track_id = newId;
+                spotifyState.current_track_title = sanitizeString(snapshot.track_name);
+                spotifyState.current_track_artist = sanitizeString(snapshot.artist_name);
+                spotifyState.current_track_duration_ms = snapshot.duration_ms; // Total length
+
+                TRACE(TRACE_TRACK_CHANGED, urlChanged);
+
+                if (urlChanged) {
+                    // Background colour comes from the art itself once it's decoded (ArtPipeline)
+                    spotifyState.current_track_url = newUrl;
+                    spotifyState.current_art_asset = ASSET_NONE;
+                    xSemaphoreTake(art_mutex, portMAX_DELAY);
+                    memcpy(art_images_shared, snapshot.art, sizeof(art_images_shared));
+                    art_image_count_shared = snapshot.art_count;
+                    xSemaphoreGive(art_mutex);
+                    // Text goes up with the new art
+                    StateBus::getInstance().publish(FIELD_TRACK_ART);
+                } else {
+                    StateBus::getInstance().publish(FIELD_TRACK_TEXT);
                 }
             }
-            return true;
+        }
+        return true;
 
-        } else {
-            // Check if we were previously playing something.
-            // Only update if we aren't already in the NOT_PLAYING state.
-            if (spotifyState.current_track_id != "NOT_PLAYING") {
-                Serial.println("Spotify: Nothing is playing");
-                spotifyState.current_track_id = "NOT_PLAYING";
-                spotifyState.current_track_title = "Nothing Playing";
-                spotifyState.current_track_artist = "-";
-                spotifyState.current_track_device_name = "No Device";
-
-                spotifyState.current_track_url = "https://raw.githubusercontent.com/Harry-Skerritt/files/refs/heads/main/not_playing_album.jpg";
-                spotifyState.album_background_cover = 0x13B94E;
-
-                spotifyState.current_track_progress_ms = 0;
-                spotifyState.current_track_duration_ms = 0;
-                spotifyState.is_playing = false;
-
-                spotifyState.needs_art_update = true;
-                spotifyState.needs_text_update = false;
-
-                if (systemState.status == SYSTEM_STATUS_ACTIVE) {
-                    Serial.println("SLEEP DEBUG: PLAYBACK STOPPED ENTERING ACTIVE STATE");
-                    systemState.status = SYSTEM_STATUS_IDLE;
-                    systemState.time_first_np = millis();
-                }
+    } else {
+        // Check if we were previously playing something.
+        // Only update if we aren't already in the NOT_PLAYING state.
+        if (spotifyState.current_track_id != "NOT_PLAYING") {
+            TRACE(TRACE_NOTHING_PLAYING);
+            spotifyState.current_track_id = "NOT_PLAYING";
+            spotifyState.current_track_title = "Nothing Playing";
+            spotifyState.current_track_artist = "-";
+            spotifyState.current_track_device_name = "No Device";
+
+            spotifyState.current_track_url = "";
+            spotifyState.current_art_asset = ASSET_NOT_PLAYING;
+            spotifyState.album_background_cover = 0x13B94E;
+            xSemaphoreTake(art_mutex, portMAX_DELAY);
+            art_image_count_shared = 0;
+            xSemaphoreGive(art_mutex);
+
+            spotifyState.setProgress(0, millis());
+            spotifyState.current_track_duration_ms = 0;
+            spotifyState.is_playing = false;
+            spotifyState.has_playback = false;
+
+            StateBus::getInstance().publish(FIELD_TRACK_ART);
+            StateBus::getInstance().publish(FIELD_BACKGROUND);
+            StateBus::getInstance().publish(FIELD_DEVICE_NAME);
+
+            if (systemState.status == SYSTEM_STATUS_ACTIVE) {
+                Lifecycle::getInstance().setSystem(SYSTEM_STATUS_IDLE, "playback stopped");
             }
-            return true;
         }
-    } catch (Spotify::Exception& e) {
-        Serial.println("Spotify: Error getting playing state!");
-        Serial.println(e.what());
-        spotifyState.status = SPOTIFY_ERROR;
-        networkState.status = WIFI_ERROR;
+        return true;
     }
-    return false;
 }
 
 
 
 // Helper
-uint32_t SpotifyManager::calculateSmartBackground(const Spotify::Extensions::VibrantPalette& palette) {
+uint32_t SpotifyManager::calculateSmartBackground(const ArtPalette& palette) {
    /* Old Logi
     float luma = (0.299f * palette.vibrant.r) +
                  (0.587f * palette.vibrant.g) +
@@ -6,12 +6,30 @@
 #define SPOTIFYMANAGER_H
 
 #include <spotify/spotify.hpp>
-#include <spotify/extensions.hpp>
 #include <lvgl.h>
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+
+#include <atomic>
+
+#include "PlaybackParser.h"
+#include "ArtPolicy.h"
+#include "network/DnsCache.h"
+#include "network/HttpDownloader.h"
+#include "ui/ArtPalette.h"
 
 extern  lv_img_dsc_t spotify_img_dsc;
 extern uint8_t* compressed_buffer;
 
+struct TokenRefreshResult {
+    bool ok = false;
+    bool revoked = false;       // invalid_grant - needs re-linking
+    bool throttled = false;     // 429 - try again once the limiter allows
+    String access_token;
+    String refresh_token;       // Only set if Spotify rotated it
+    uint32_t expires_in = 0;    // Seconds
+};
+
 class SpotifyManager {
 public:
 
@@ -23,29 +41,93 @@ public:
     void init();
     void update();
 
-    void buildAuthURL();
+    void buildAuthURL();    // Cached until the IP or client id changes
 
-    void loadAlbumArt(String& url, short target_size);
+    // Queues a download on the art task, the graphics task collects it with takeAlbumArt.
+    // request_url is the url it was asked for, the image fetched may be another size of it
+    void requestAlbumArt(const String& url, short target_size);
+    bool takeAlbumArt(uint8_t*& data, size_t& len, short& target_size, String& request_url);
 
     bool getCurrentlyPlaying();
 
+    const PollStats& getPollStats() const { return poll_stats; }
+    DownloadStats getArtDownloadStats();
+
+    // OAuth callback from the StatusServer - false if we aren't waiting for one
+    bool receiveAuthCode(const String& code);
+
+    // Picks the background colour from the palette built while the art was decoded
+    static uint32_t calculateSmartBackground(const ArtPalette& palette);
+
 
 private:
-    SpotifyManager() {}
+    SpotifyManager() { art_mutex = xSemaphoreCreateMutex(); }
 
     Spotify::Auth* sp_auth = nullptr;
     Spotify::Client* sp_client = nullptr;
 
 
-    // Web Server + Getting Code
-    bool isServerRunning = false;
+    // Getting Code
+    String auth_url_key;
     std::string temp_auth_code;
-    void handleCodeWebServer();
     void handleAuthCodeExchange();
 
     void handleRefreshValidation();
 
-    uint32_t calculateSmartBackground(const Spotify::Extensions::VibrantPalette& palette);
+    // Token Refresh
+    uint32_t token_refresh_due = 0;
+    uint32_t token_retry_delay = 0;
+    std::atomic<bool> token_refresh_running{false};
+    std::atomic<bool> token_refresh_ready{false};
+    TokenRefreshResult pending_refresh;
+    String refresh_client_id;       // Copied for the refresh task, spotifyState is the system task's
+    String refresh_client_secret;
+    String refresh_token_copy;
+    void scheduleTokenRefresh();
+    void startTokenRefresh();
+    void applyTokenResult(const TokenRefreshResult& result);
+    static bool requestAccessToken(const String& client_id, const String& client_secret,
+                                   const String& refresh_token, TokenRefreshResult& result);
+
+    // Lean Polling
+    CachedSecureClient api_client;  // Resolves through DnsCache
+    HTTPClient api_http;
+    PlaybackSnapshot snapshot;
+    PollStats poll_stats;
+    uint32_t last_fingerprint = 0;
+    String api_bearer;
+    void updateBearer();
+    int fetchPlaybackState(PlaybackSnapshot& out);
+
+    // Album Art
+    HttpDownloader art_downloader;
+    ArtPolicy art_policy;
+    ArtImage art_images[ART_MAX_IMAGES];    // Sizes on offer for the current album, art task's copy
+    uint8_t art_image_count = 0;
+    String art_upgrade_url;
+    String art_upgrade_request;
+    short art_upgrade_size = 0;
+    TaskHandle_t art_task = nullptr;
+    uint32_t art_hold_until = 0;            // CDN Retry-After, art task only
+    bool art_held = false;
+
+    SemaphoreHandle_t art_mutex = nullptr;  // Guards the job, the album's sizes and the handoff slots
+    ArtImage art_images_shared[ART_MAX_IMAGES];     // Written by the poll, copied into art_images
+    uint8_t art_image_count_shared = 0;
+    DownloadStats art_stats;
+    String art_job_url;
+    short art_job_size = 0;
+    bool art_job_pending = false;
+    uint8_t* art_ready = nullptr;
+    size_t art_ready_len = 0;
+    short art_ready_size = 0;
+    String art_ready_request;
+
+    static void artTask(void* pvParameters);
+    uint32_t processAlbumArt();     // ms until it wants another pass, 0 if nothing is owed
+    bool loadAlbumArt(const String& url, short target_size, const String& request_url);
+    uint32_t requeueAlbumArt(const String& url, short target_size);
+
 
 
     SpotifyManager(const SpotifyManager&) = delete;
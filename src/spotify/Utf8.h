@@ -0,0 +1,46 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// No Arduino dependencies - builds on the host as-is
+
+// strlcpy that truncates on a code point boundary, a cut multi-byte character
+// would render as junk. Returns the length written
+inline size_t utf8Copy(char* dst, size_t dst_len, const char* src) {
+    if (dst_len == 0) return 0;
+    if (!src) src = "";
+
+    size_t len = strlen(src);
+    if (len < dst_len) {
+        memcpy(dst, src, len + 1);
+        return len;
+    }
+
+    size_t end = dst_len - 1;
+    memcpy(dst, src, end);
+    dst[end] = '\0';
+
+    // Back up over continuation bytes (10xxxxxx) to the lead byte of the cut character
+    size_t lead = end;
+    while (lead > 0 && ((uint8_t)dst[lead - 1] & 0xC0) == 0x80) lead--;
+    if (lead == 0) return end;
+
+    // Keep it only if all of its bytes made it
+    uint8_t c = (uint8_t)dst[lead - 1];
+    size_t need = c < 0x80 ? 1 : c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+    if (end - (lead - 1) >= need) return end;
+
+    dst[lead - 1] = '\0';
+    return lead - 1;
+}
+
+
+
+#endif //UTF8_H
@@ -0,0 +1,89 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "BootSequencer.h"
+
+#include "Telemetry.h"
+
+static const char* milestoneNames[BOOT_MILESTONE_COUNT] = {
+    "wifi_connected",
+    "spotify_ready",
+    "first_art",
+};
+
+void BootSequencer::addStage(BootStage stage, const char *name, uint32_t deps, void (*fn)(), BaseType_t core) {
+    stages[stage].name = name;
+    stages[stage].deps = deps;
+    stages[stage].fn = fn;
+    stages[stage].core = core;
+}
+
+void BootSequencer::run() {
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        if (stages[i].fn == nullptr) {
+            // Nothing registered - don't hold up anything waiting on it
+            xEventGroupSetBits(events, BOOT_BIT(i));
+            continue;
+        }
+
+        xTaskCreatePinnedToCore(stageTask, stages[i].name, 8192, (void*)(uintptr_t)i, 2, NULL, stages[i].core);
+    }
+}
+
+void BootSequencer::stageTask(void *pvParameters) {
+    BootSequencer& boot = getInstance();
+    Stage& stage = boot.stages[(uintptr_t)pvParameters];
+
+    if (stage.deps) {
+        xEventGroupWaitBits(boot.events, stage.deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+
+    stage.start_ms = millis();
+    stage.fn();
+    stage.end_ms = millis();
+
+    xEventGroupSetBits(boot.events, BOOT_BIT((uintptr_t)pvParameters));
+    Telemetry::getInstance().taskFinished();
+    vTaskDelete(NULL);
+}
+
+void BootSequencer::waitFor(uint32_t mask) {
+    xEventGroupWaitBits(events, mask, pdFALSE, pdTRUE, portMAX_DELAY);
+}
+
+bool BootSequencer::isDone(uint32_t mask) {
+    return (xEventGroupGetBits(events) & mask) == mask;
+}
+
+void BootSequencer::mark(BootMilestone milestone) {
+    if (milestones[milestone] != 0) return;
+    milestones[milestone] = millis();
+
+    if (milestone == BOOT_MILESTONE_FIRST_ART && !reported) {
+        reported = true;
+        printReport();
+    }
+}
+
+void BootSequencer::printReport() {
+    Serial.println("Boot: --- Timeline (ms since power on) ---");
+
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        const Stage& s = stages[i];
+        if (s.fn == nullptr) continue;
+
+        if (s.end_ms == 0) {
+            Serial.printf("Boot:   %-14s still running\n", s.name);
+            continue;
+        }
+
+        Serial.printf("Boot:   %-14s %5u -> %5u (%4u ms, core %d)\n",
+            s.name, s.start_ms, s.end_ms, s.end_ms - s.start_ms, s.core);
+    }
+
+    for (int i = 0; i < BOOT_MILESTONE_COUNT; i++) {
+        if (milestones[i] == 0) continue;
+        Serial.printf("Boot:   %-14s %5u\n", milestoneNames[i], milestones[i]);
+    }
+}
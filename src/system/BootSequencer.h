@@ -0,0 +1,75 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef BOOTSEQUENCER_H
+#define BOOTSEQUENCER_H
+
+#include <Arduino.h>
+#include <freertos/event_groups.h>
+
+#define BOOT_BIT(stage) (1UL << (stage))
+
+enum BootStage {
+    BOOT_STAGE_HAL,          // Panel, touch, lv_init
+    BOOT_STAGE_FS,           // LittleFS mount
+    BOOT_STAGE_CONFIG,       // config / secrets / tokens
+    BOOT_STAGE_UI,           // Styles, decoders
+    BOOT_STAGE_WIFI,         // Association started
+    BOOT_STAGE_RESET_WINDOW, // Hard reset button window closed
+    BOOT_STAGE_COUNT
+};
+
+enum BootMilestone {
+    BOOT_MILESTONE_WIFI_CONNECTED,
+    BOOT_MILESTONE_SPOTIFY_READY,
+    BOOT_MILESTONE_FIRST_ART,
+    BOOT_MILESTONE_COUNT
+};
+
+// Runs each boot stage in its own task as soon as the stages it depends on
+// have finished, so independent work (WiFi, FS, display) overlaps
+class BootSequencer {
+public:
+    static BootSequencer& getInstance() {
+        static BootSequencer instance;
+        return instance;
+    }
+
+    void addStage(BootStage stage, const char* name, uint32_t deps, void (*fn)(), BaseType_t core);
+    void run();
+
+    // Blocks the calling task until every stage in mask has finished
+    void waitFor(uint32_t mask);
+    bool isDone(uint32_t mask);
+
+    // Records the first time a milestone is hit, prints the timeline at first art
+    void mark(BootMilestone milestone);
+    void printReport();
+
+private:
+    BootSequencer() { events = xEventGroupCreate(); }
+
+    struct Stage {
+        const char* name = nullptr;
+        uint32_t deps = 0;
+        void (*fn)() = nullptr;
+        BaseType_t core = 0;
+        uint32_t start_ms = 0;
+        uint32_t end_ms = 0;
+    };
+
+    Stage stages[BOOT_STAGE_COUNT];
+    uint32_t milestones[BOOT_MILESTONE_COUNT] = {};
+    EventGroupHandle_t events = nullptr;
+    bool reported = false;
+
+    static void stageTask(void* pvParameters);
+
+    BootSequencer(const BootSequencer&) = delete;
+    void operator=(const BootSequencer&) = delete;
+};
+
+
+
+#endif //BOOTSEQUENCER_H
@@ -0,0 +1,197 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "Lifecycle.h"
+
+#include "BootSequencer.h"
+#include "StateBus.h"
+#include "SystemManager.h"
+
+// --- WiFi ---
+static void wifiSettlingEntry() {
+    Lifecycle& lc = Lifecycle::getInstance();
+
+    // Spotify doesn't wait for the confirmation screen, only its own screens do
+    if (lc.spotify.current() == SPOTIFY_IDLE) {
+        if (spotifyState.refresh_token.length() > 0) lc.setSpotify(SPOTIFY_INITIALIZING, "wifi up");
+        else if (systemState.spotify_linked) lc.setSpotify(SPOTIFY_LINK_ERROR, "wifi up, token missing");
+        else lc.setSpotify(SPOTIFY_NEED_LINK, "wifi up");
+    }
+
+    lc.wifi.armTimer(Lifecycle::wifiSettleMs());
+}
+
+static uint8_t wifiSettlingTimeout() {
+    return WIFI_STATE_ONLINE;
+}
+
+static void wifiOnlineEntry() {
+    // Route to whichever Spotify screen is due, even if the status didn't change while WiFi was away
+    StateBus::getInstance().publish(FIELD_SPOTIFY_STATUS);
+}
+
+static const SmState wifiStates[WIFI_STATE_COUNT] = {
+    {"IDLE", WIFI_STATE_OFFLINE, SM_NONE, nullptr, nullptr, nullptr},
+    {"SCANNING", WIFI_STATE_OFFLINE, SM_NONE, nullptr, nullptr, nullptr},
+    {"SCAN_RESULTS", WIFI_STATE_OFFLINE, SM_NONE, nullptr, nullptr, nullptr},
+    {"CONNECTING", SM_NONE, SM_NONE, nullptr, nullptr, nullptr},
+    {"CONNECTED", SM_NONE, WIFI_STATE_SETTLING, nullptr, nullptr, nullptr},
+    {"ERROR", WIFI_STATE_OFFLINE, SM_NONE, nullptr, nullptr, nullptr},
+    {"SETTLING", WIFI_CONNECTED, SM_NONE, wifiSettlingEntry, nullptr, wifiSettlingTimeout},
+    {"ONLINE", WIFI_CONNECTED, SM_NONE, wifiOnlineEntry, nullptr, nullptr},
+    {"OFFLINE", SM_NONE, WIFI_IDLE, nullptr, nullptr, nullptr},
+};
+
+static const SmTransition wifiTable[] = {
+    {SM_ANY, WIFI_IDLE},                            // Reset
+    {SM_ANY, WIFI_CONNECTING},                      // Connect / retry from any screen
+    {WIFI_STATE_OFFLINE, WIFI_SCANNING},
+    {WIFI_STATE_OFFLINE, WIFI_SCAN_RESULTS},        // Cached results, or the first ones in
+    {WIFI_IDLE, WIFI_ERROR},                        // Set up, but the credentials are gone
+    {WIFI_SCANNING, WIFI_ERROR},                    // Scan wouldn't start
+    {WIFI_CONNECTING, WIFI_CONNECTED},
+    {WIFI_CONNECTING, WIFI_ERROR},
+    {WIFI_STATE_SETTLING, WIFI_STATE_ONLINE},
+};
+
+static void wifiChanged(uint8_t state) {
+    WifiStatus status = (state == WIFI_STATE_SETTLING || state == WIFI_STATE_ONLINE)
+                        ? WIFI_CONNECTED : (WifiStatus)state;
+    if (networkState.status == status) return;
+
+    networkState.status = status;
+    StateBus::getInstance().publish(FIELD_WIFI_STATUS);
+}
+
+// --- Spotify ---
+static void spotifyReadyEntry() {
+    BootSequencer::getInstance().mark(BOOT_MILESTONE_SPOTIFY_READY);
+}
+
+static const SmState spotifyStates[SPOTIFY_STATE_COUNT] = {
+    {"IDLE", SM_NONE, SM_NONE, nullptr, nullptr, nullptr},
+    {"INITIALIZING", SPOTIFY_STATE_SESSION, SM_NONE, nullptr, nullptr, nullptr},
+    {"NEED_LINK", SPOTIFY_STATE_UNLINKED, SM_NONE, nullptr, nullptr, nullptr},
+    {"LINKING", SPOTIFY_STATE_UNLINKED, SM_NONE, nullptr, nullptr, nullptr},
+    {"AUTHENTICATING", SPOTIFY_STATE_SESSION, SM_NONE, nullptr, nullptr, nullptr},
+    {"READY", SPOTIFY_STATE_SESSION, SM_NONE, spotifyReadyEntry, nullptr, nullptr},
+    {"LINK_ERROR", SPOTIFY_STATE_UNLINKED, SM_NONE, nullptr, nullptr, nullptr},
+    {"ERROR", SM_NONE, SM_NONE, nullptr, nullptr, nullptr},
+    {"UNLINKED", SM_NONE, SPOTIFY_NEED_LINK, nullptr, nullptr, nullptr},
+    {"SESSION", SM_NONE, SPOTIFY_INITIALIZING, nullptr, nullptr, nullptr},
+};
+
+static const SmTransition spotifyTable[] = {
+    {SPOTIFY_IDLE, SPOTIFY_INITIALIZING},           // Saved token
+    {SPOTIFY_IDLE, SPOTIFY_NEED_LINK},              // Never linked, or tokens.json missing
+    {SPOTIFY_IDLE, SPOTIFY_LINK_ERROR},             // Linked before, token lost
+    {SPOTIFY_INITIALIZING, SPOTIFY_READY},
+    {SPOTIFY_INITIALIZING, SPOTIFY_LINK_ERROR},     // Refresh rejected
+    {SPOTIFY_STATE_UNLINKED, SPOTIFY_AUTHENTICATING}, // Auth server got a code
+    {SPOTIFY_LINK_ERROR, SPOTIFY_NEED_LINK},        // Relink button
+    {SPOTIFY_AUTHENTICATING, SPOTIFY_READY},
+    {SPOTIFY_AUTHENTICATING, SPOTIFY_ERROR},
+    {SPOTIFY_READY, SPOTIFY_LINK_ERROR},            // Refresh token revoked
+    {SPOTIFY_READY, SPOTIFY_ERROR},                 // Poll failed
+    {SPOTIFY_ERROR, SPOTIFY_AUTHENTICATING},        // Retry button
+    {SPOTIFY_ERROR, SPOTIFY_NEED_LINK},             // Relink button
+};
+
+static void spotifyChanged(uint8_t state) {
+    spotifyState.status = (SpotifyStatus)state;
+    StateBus::getInstance().publish(FIELD_SPOTIFY_STATUS);
+}
+
+// --- System ---
+// Stopped and paused sleep after different times, and a pause can become a stop
+// while idle, so the deadline is worked out again on every check
+static uint32_t idleSleepTimeout() {
+    return spotifyState.has_playback ? PAUSE_SLEEP_TIMEOUT_MS : SLEEP_TIMEOUT_MS;
+}
+
+static void systemIdleEntry() {
+    systemState.time_first_np = millis();
+    Lifecycle::getInstance().system.armTimer(LIFECYCLE_SLEEP_RECHECK_MS);
+}
+
+static uint8_t systemIdleTimeout() {
+    uint32_t idle = millis() - systemState.time_first_np;
+    uint32_t timeout = idleSleepTimeout();
+
+    // Only sleeps while on WiFi
+    if (idle < timeout || !networkState.wifi_connected) {
+        uint32_t left = (idle < timeout) ? timeout - idle : LIFECYCLE_SLEEP_RECHECK_MS;
+        Lifecycle::getInstance().system.armTimer(min(left, (uint32_t)LIFECYCLE_SLEEP_RECHECK_MS));
+        return SM_NONE;
+    }
+    return SYSTEM_STATUS_SLEEP;
+}
+
+static void systemSleepEntry() {
+    SystemManager::getInstance().enterSleepMode();
+
+    // Quiet moment - good time for the dwell times
+    Lifecycle::getInstance().printReport();
+}
+
+static void systemSleepExit() {
+    // Usually left from the system task, so the screen is rebuilt by the graphics task
+    SystemManager::getInstance().requestWake();
+}
+
+static const SmState systemStates[SYSTEM_STATE_COUNT] = {
+    {"IDLE", SYSTEM_STATE_AWAKE, SM_NONE, systemIdleEntry, nullptr, systemIdleTimeout},
+    {"ACTIVE", SYSTEM_STATE_AWAKE, SM_NONE, nullptr, nullptr, nullptr},
+    {"SLEEP", SM_NONE, SM_NONE, systemSleepEntry, systemSleepExit, nullptr},
+    {"AWAKE", SM_NONE, SYSTEM_STATUS_ACTIVE, nullptr, nullptr, nullptr},
+};
+
+static const SmTransition systemTable[] = {
+    {SYSTEM_STATUS_ACTIVE, SYSTEM_STATUS_IDLE},     // Paused / stopped
+    {SYSTEM_STATUS_IDLE, SYSTEM_STATUS_ACTIVE},     // Resumed
+    {SYSTEM_STATUS_IDLE, SYSTEM_STATUS_SLEEP},      // Idle timer
+    {SYSTEM_STATUS_SLEEP, SYSTEM_STATUS_ACTIVE},    // Resumed while asleep
+};
+
+static void systemChanged(uint8_t state) {
+    systemState.status = (SystemStatus)state;
+}
+
+// --- Lifecycle ---
+Lifecycle::Lifecycle() {
+    wifi.init("wifi", wifiStates, WIFI_STATE_COUNT,
+              wifiTable, sizeof(wifiTable) / sizeof(wifiTable[0]), WIFI_IDLE, wifiChanged);
+    spotify.init("spotify", spotifyStates, SPOTIFY_STATE_COUNT,
+                 spotifyTable, sizeof(spotifyTable) / sizeof(spotifyTable[0]), SPOTIFY_IDLE, spotifyChanged);
+    system.init("system", systemStates, SYSTEM_STATE_COUNT,
+                systemTable, sizeof(systemTable) / sizeof(systemTable[0]), SYSTEM_STATUS_ACTIVE, systemChanged);
+}
+
+bool Lifecycle::setWifi(WifiStatus status, const char *cause) {
+    return wifi.transition(status, cause);
+}
+
+bool Lifecycle::setSpotify(SpotifyStatus status, const char *cause) {
+    return spotify.transition(status, cause);
+}
+
+bool Lifecycle::setSystem(SystemStatus status, const char *cause) {
+    return system.transition(status, cause);
+}
+
+void Lifecycle::update() {
+    wifi.update();
+    spotify.update();
+    system.update();
+}
+
+uint32_t Lifecycle::wifiSettleMs() {
+    return (spotifyState.refresh_token.length() > 0) ? 0 : LIFECYCLE_WIFI_SETTLE_MS;
+}
+
+void Lifecycle::printReport() {
+    wifi.printReport();
+    spotify.printReport();
+    system.printReport();
+}
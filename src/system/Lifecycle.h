@@ -0,0 +1,72 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef LIFECYCLE_H
+#define LIFECYCLE_H
+
+#include <Arduino.h>
+
+#include "global_state.h"
+#include "StateMachine.h"
+
+// Onboarding keeps "WiFi Connected!" up this long, a linked device doesn't wait
+#define LIFECYCLE_WIFI_SETTLE_MS 1000
+#define LIFECYCLE_SLEEP_RECHECK_MS 1000
+
+// WiFi states past the WifiStatus values - CONNECTED is the parent of SETTLING and ONLINE
+enum WifiLifecycleState {
+    WIFI_STATE_SETTLING = WIFI_ERROR + 1,  // Confirmation on screen
+    WIFI_STATE_ONLINE,                      // Spotify screens can take over
+    WIFI_STATE_OFFLINE,                     // IDLE, SCANNING, SCAN_RESULTS, ERROR
+    WIFI_STATE_COUNT
+};
+
+// Spotify parents past the SpotifyStatus values
+enum SpotifyLifecycleState {
+    SPOTIFY_STATE_UNLINKED = SPOTIFY_ERROR + 1,    // NEED_LINK, LINKING, LINK_ERROR
+    SPOTIFY_STATE_SESSION,                          // INITIALIZING, AUTHENTICATING, READY
+    SPOTIFY_STATE_COUNT
+};
+
+enum SystemLifecycleState {
+    SYSTEM_STATE_AWAKE = SYSTEM_STATUS_SLEEP + 1,  // IDLE, ACTIVE
+    SYSTEM_STATE_COUNT
+};
+
+// Owns the WiFi, Spotify and System state machines. The status fields in the global
+// state are written only from here, every change goes through a transition table
+class Lifecycle {
+public:
+    static Lifecycle& getInstance() {
+        static Lifecycle instance;
+        return instance;
+    }
+
+    bool setWifi(WifiStatus status, const char* cause);
+    bool setSpotify(SpotifyStatus status, const char* cause);
+    bool setSystem(SystemStatus status, const char* cause);
+
+    // Fires due timers - called every frame from the graphics task
+    void update();
+
+    // WiFi is up and its confirmation has had its time on screen
+    bool isWifiSettled() const { return wifi.isIn(WIFI_STATE_ONLINE); }
+    static uint32_t wifiSettleMs();
+
+    void printReport();
+
+    StateMachine wifi;
+    StateMachine spotify;
+    StateMachine system;
+
+private:
+    Lifecycle();
+
+    Lifecycle(const Lifecycle&) = delete;
+    void operator=(const Lifecycle&) = delete;
+};
+
+
+
+#endif //LIFECYCLE_H
@@ -0,0 +1,58 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef STATEBUS_H
+#define STATEBUS_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Parts of the global state the UI draws from
+enum StateField {
+    FIELD_WIFI_STATUS,      // networkState.status
+    FIELD_LINK_LOST,        // networkState.link_lost
+    FIELD_SCAN_RESULTS,     // networkState.found_networks
+    FIELD_SPOTIFY_STATUS,   // spotifyState.status
+    FIELD_TRACK_TEXT,       // Title / artist
+    FIELD_TRACK_ART,        // current_track_url / current_art_asset
+    FIELD_ART_READY,        // Downloaded art waiting in SpotifyManager
+    FIELD_BACKGROUND,       // album_background_cover
+    FIELD_DEVICE_NAME,      // current_track_device_name
+    FIELD_COUNT
+};
+
+// Producers write a field of the global state then publish it, which bumps that
+// field's version. Consumers remember the last version they applied, so changes
+// are never lost to a flag being cleared on the other core - several publishes
+// between frames just fold into one
+class StateBus {
+public:
+    static StateBus& getInstance() {
+        static StateBus instance;
+        return instance;
+    }
+
+    void publish(StateField field) {
+        versions[field].fetch_add(1, std::memory_order_release);
+        sequence.fetch_add(1, std::memory_order_release);
+    }
+
+    uint32_t version(StateField field) const { return versions[field].load(std::memory_order_acquire); }
+
+    // Moves on every publish - unchanged means nothing to do
+    uint32_t getSequence() const { return sequence.load(std::memory_order_acquire); }
+
+private:
+    StateBus() {}
+
+    std::atomic<uint32_t> versions[FIELD_COUNT] = {};
+    std::atomic<uint32_t> sequence{0};
+
+    StateBus(const StateBus&) = delete;
+    void operator=(const StateBus&) = delete;
+};
+
+
+
+#endif //STATEBUS_H
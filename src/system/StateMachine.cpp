@@ -0,0 +1,184 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "StateMachine.h"
+
+void StateMachine::init(const char *machine_name, const SmState *state_table, uint8_t count,
+                        const SmTransition *transitions, uint8_t transitions_count,
+                        uint8_t initial, void (*change_cb)(uint8_t)) {
+    name = machine_name;
+    states = state_table;
+    state_count = count > SM_MAX_STATES ? SM_MAX_STATES : count;
+    table = transitions;
+    transition_count = transitions_count;
+    on_change = change_cb;
+
+    // Starts in the initial leaf without running its entry actions - the globals already match
+    while (states[initial].initial != SM_NONE) initial = states[initial].initial;
+    state = initial;
+
+    uint32_t now = millis();
+    for (uint8_t s = initial; s != SM_NONE; s = states[s].parent) {
+        entered_ms[s] = now;
+        stats[s].entries++;
+    }
+}
+
+bool StateMachine::isWithin(uint8_t s, uint8_t ancestor) const {
+    for (; s != SM_NONE; s = states[s].parent) {
+        if (s == ancestor) return true;
+    }
+    return false;
+}
+
+bool StateMachine::isIn(uint8_t s) const {
+    return isWithin(state, s);
+}
+
+const char* StateMachine::stateName(uint8_t s) const {
+    return s < state_count ? states[s].name : "?";
+}
+
+bool StateMachine::allowed(uint8_t to) const {
+    for (uint8_t i = 0; i < transition_count; i++) {
+        if (table[i].to != to) continue;
+        if (table[i].from == SM_ANY || isWithin(state, table[i].from)) return true;
+    }
+    return false;
+}
+
+bool StateMachine::transition(uint8_t to, const char *cause) {
+    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    bool ok = run(to, cause, 0);
+    xSemaphoreGiveRecursive(mutex);
+    return ok;
+}
+
+bool StateMachine::run(uint8_t to, const char *cause, uint32_t late_ms) {
+    if (to >= state_count) return false;
+
+    // Already there
+    if (isIn(to)) return true;
+
+    if (!allowed(to)) {
+        illegal_count++;
+        Serial.printf("Lifecycle: %s illegal %s -> %s (%s)\n", name, states[state].name, states[to].name, cause);
+        return false;
+    }
+
+    uint8_t target = to;
+    while (states[target].initial != SM_NONE) target = states[target].initial;
+
+    uint32_t now = millis();
+    uint32_t start = micros();
+    uint8_t from = state;
+    uint32_t dwell = now - entered_ms[from];
+    timer_armed = false;
+
+    // Exits, innermost first, up to the first parent the target shares
+    for (uint8_t s = from; s != SM_NONE && !isWithin(target, s); s = states[s].parent) {
+        if (states[s].on_exit) states[s].on_exit();
+
+        uint32_t spent = now - entered_ms[s];
+        stats[s].total_ms += spent;
+        if (spent > stats[s].max_ms) stats[s].max_ms = spent;
+    }
+
+    state = target;
+    if (on_change) on_change(target);
+
+    // Entries, outermost first, down from below the shared parent
+    uint8_t path[SM_MAX_DEPTH];
+    uint8_t depth = 0;
+    for (uint8_t s = target; s != SM_NONE && !isWithin(from, s) && depth < SM_MAX_DEPTH; s = states[s].parent) {
+        path[depth++] = s;
+    }
+    while (depth > 0) {
+        uint8_t s = path[--depth];
+        entered_ms[s] = now;
+        stats[s].entries++;
+        if (states[s].on_entry) states[s].on_entry();
+    }
+
+    uint32_t action_us = micros() - start;
+
+    SmTrace& t = trace[trace_head];
+    t.from = from;
+    t.to = target;
+    t.at_ms = now;
+    t.dwell_ms = dwell;
+    t.action_us = action_us;
+    t.late_ms = late_ms;
+    t.cause = cause;
+    trace_head = (trace_head + 1) % SM_TRACE_DEPTH;
+    if (trace_count < SM_TRACE_DEPTH) trace_count++;
+
+    Serial.printf("Lifecycle: %s %s -> %s (%s) after %u ms, actions %u us",
+        name, states[from].name, states[target].name, cause, dwell, action_us);
+    if (late_ms) Serial.printf(", timer %u ms late", late_ms);
+    Serial.println();
+
+    // Zero length timer - nothing to wait for
+    if (timer_armed && timer_ms == 0) fireTimer(0);
+
+    return true;
+}
+
+void StateMachine::armTimer(uint32_t ms) {
+    timer_armed = true;
+    timer_start = millis();
+    timer_ms = ms;
+}
+
+void StateMachine::update() {
+    if (!timer_armed) return;
+
+    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    uint32_t elapsed = millis() - timer_start;
+    if (timer_armed && elapsed >= timer_ms) fireTimer(elapsed - timer_ms);
+    xSemaphoreGiveRecursive(mutex);
+}
+
+void StateMachine::fireTimer(uint32_t late_ms) {
+    timer_armed = false;
+
+    // The handler can re-arm to keep waiting
+    uint8_t next = states[state].on_timeout ? states[state].on_timeout() : SM_NONE;
+    if (next != SM_NONE) run(next, "timeout", late_ms);
+}
+
+void StateMachine::copyTrace(SmTrace *out, uint8_t &count) {
+    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    count = trace_count;
+    for (uint8_t i = 0; i < trace_count; i++) {
+        out[i] = trace[(trace_head + SM_TRACE_DEPTH - trace_count + i) % SM_TRACE_DEPTH];
+    }
+    xSemaphoreGiveRecursive(mutex);
+}
+
+void StateMachine::printReport() {
+    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+
+    Serial.printf("Lifecycle: --- %s (now %s, %u illegal) ---\n", name, states[state].name, illegal_count);
+
+    uint32_t now = millis();
+    for (uint8_t s = 0; s < state_count; s++) {
+        const SmStateStats& st = stats[s];
+        if (st.entries == 0) continue;
+
+        // Count the visit that's still going
+        uint32_t total = st.total_ms;
+        uint32_t max_ms = st.max_ms;
+        if (isIn(s)) {
+            uint32_t spent = now - entered_ms[s];
+            total += spent;
+            if (spent > max_ms) max_ms = spent;
+        }
+
+        Serial.printf("Lifecycle:   %-16s x%-3u total %7u ms, max %7u ms%s\n",
+            states[s].name, st.entries, total, max_ms, isIn(s) ? " <" : "");
+    }
+
+    xSemaphoreGiveRecursive(mutex);
+}
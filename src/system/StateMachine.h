@@ -0,0 +1,108 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef STATEMACHINE_H
+#define STATEMACHINE_H
+
+#include <Arduino.h>
+#include <freertos/semphr.h>
+
+#define SM_NONE 0xFF            // No state - top level parent, leaf initial, stay on timeout
+#define SM_ANY 0xFE             // Transition source that matches every state
+#define SM_MAX_STATES 12
+#define SM_MAX_DEPTH 4
+#define SM_TRACE_DEPTH 8
+
+struct SmState {
+    const char* name;
+    uint8_t parent;             // SM_NONE at the top
+    uint8_t initial;            // Child entered when this is the target, SM_NONE for leaves
+    void (*on_entry)();
+    void (*on_exit)();
+    uint8_t (*on_timeout)();    // Where to go when the timer armed on entry fires, SM_NONE to stay
+};
+
+struct SmTransition {
+    uint8_t from;               // A state, one of its parents, or SM_ANY
+    uint8_t to;
+};
+
+struct SmStateStats {
+    uint32_t entries = 0;
+    uint32_t total_ms = 0;
+    uint32_t max_ms = 0;
+};
+
+struct SmTrace {
+    uint8_t from;
+    uint8_t to;
+    uint32_t at_ms;
+    uint32_t dwell_ms;          // Time spent in the state that was left
+    uint32_t action_us;         // Exit + entry actions
+    uint32_t late_ms;           // How far past its deadline a timer fired
+    const char* cause;
+};
+
+// Hierarchical state machine driven by a transition table. States are indices into
+// the state table, leaves are what the machine sits in. Every transition runs the
+// exit actions up to the common parent, then the entry actions down to the target,
+// and is traced with its timings. Anything not in the table is rejected and counted
+class StateMachine {
+public:
+    StateMachine() { mutex = xSemaphoreCreateRecursiveMutex(); }
+
+    // on_change runs between the exits and the entries with the new leaf
+    void init(const char* name, const SmState* states, uint8_t state_count,
+              const SmTransition* table, uint8_t transition_count,
+              uint8_t initial, void (*on_change)(uint8_t state));
+
+    // Entry actions must not transition their own machine - arm a timer instead
+    bool transition(uint8_t to, const char* cause);
+
+    // Only valid from an entry action, the timer is dropped when the state is left
+    void armTimer(uint32_t ms);
+
+    // Fires the current state's timer once it's due
+    void update();
+
+    uint8_t current() const { return state; }
+    bool isIn(uint8_t s) const;             // The current state or one of its parents
+    const char* stateName(uint8_t s) const;
+    uint32_t getIllegalCount() const { return illegal_count; }
+
+    void printReport();
+    void copyTrace(SmTrace* out, uint8_t& count);
+
+private:
+    const char* name = "";
+    const SmState* states = nullptr;
+    uint8_t state_count = 0;
+    const SmTransition* table = nullptr;
+    uint8_t transition_count = 0;
+    void (*on_change)(uint8_t state) = nullptr;
+
+    volatile uint8_t state = SM_NONE;
+    uint32_t entered_ms[SM_MAX_STATES] = {};
+    SmStateStats stats[SM_MAX_STATES];
+    uint32_t illegal_count = 0;
+
+    bool timer_armed = false;
+    uint32_t timer_start = 0;
+    uint32_t timer_ms = 0;
+
+    SmTrace trace[SM_TRACE_DEPTH];
+    uint8_t trace_head = 0;
+    uint8_t trace_count = 0;
+
+    SemaphoreHandle_t mutex = nullptr;
+
+    bool isWithin(uint8_t s, uint8_t ancestor) const;
+    bool allowed(uint8_t to) const;
+    void fireTimer(uint32_t late_ms);
+    bool run(uint8_t to, const char* cause, uint32_t late_ms);
+};
+
+
+
+#endif //STATEMACHINE_H
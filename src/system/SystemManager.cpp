@@ -11,24 +11,26 @@
 #include "global_state.h"
 #include "../../../../../../.platformio/packages/toolchain-riscv32-esp/riscv32-esp-elf/include/c++/8.4.0/set"
 #include "network/WifiManager.h"
+#include "system/Lifecycle.h"
+#include "system/TraceLog.h"
 #include "ui/UIManager.h"
 
 
 void SystemManager::init() {
-    systemState.status = SYSTEM_STATUS_ACTIVE;
+    Lifecycle& lifecycle = Lifecycle::getInstance();
 
     // --- Loading ---
     // Handling Config.json
     if (!loadConfig()) {
         //  Device definitely hasn't been set up
         Serial.println("Failed to load config");
-        networkState.status = WIFI_IDLE;
+        lifecycle.setWifi(WIFI_IDLE, "no config");
     }
 
     // Handling Secret.json
     if (!loadSpotifySecrets()) {
         Serial.println("Failed to load spotify secrets");
-        UIManager::getInstance().showFailure();
+        systemState.boot_failed = true;
         return;
     }
 
@@ -36,15 +38,15 @@ void SystemManager::init() {
     if (!loadSpotifyTokens()) {
         Serial.println("Failed to load spotify tokens");
         // This isn't critical but will mean spotify needs relinking
-        spotifyState.status = SPOTIFY_NEED_LINK;
         spotifyState.refresh_token = "";
+        lifecycle.setSpotify(SPOTIFY_NEED_LINK, "no tokens");
     }
 
     // --- Spotify Check ---
     if (spotifyState.client_id.length() == 0)
     {
         Serial.println("Spotify Credentials are missing - aborting!");
-        UIManager::getInstance().showFailure();
+        systemState.boot_failed = true;
         return;
     }
 
@@ -56,27 +58,16 @@ void SystemManager::init() {
         if (networkState.selected_ssid.length() > 0 &&
             networkState.selected_pass.length() > 0)
         {
-            networkState.status = WIFI_CONNECTING; // Preempt the connection and hopefully avoid errors
-
-            //WifiManager::getInstance().requestConnect();
-            connectionRequested = true;
-            String msg = "Connecting to " + networkState.selected_ssid;
-            UIManager::getInstance().showSpinner(msg.c_str());
+            // Boot sequencer starts the association straight after this
+            lifecycle.setWifi(WIFI_CONNECTING, "saved network");
         }
         else {
             // Has been set up but wi-fi failed
-            networkState.status = WIFI_ERROR;
+            lifecycle.setWifi(WIFI_ERROR, "no saved credentials");
         }
     } else {
         // Device has not been set up - initiate onboarding
-        networkState.status = WIFI_IDLE;
-    }
-}
-
-void SystemManager::update() {
-    if (connectionRequested) {
-        WifiManager::getInstance().requestConnect();
-        connectionRequested = false;
+        lifecycle.setWifi(WIFI_IDLE, "onboarding");
     }
 }
 
@@ -104,6 +95,24 @@ bool SystemManager::loadConfig() {
     systemState.setup_complete = doc["setup_complete"].as<bool>();
     systemState.spotify_linked = doc["spotify_linked"].as<bool>();
 
+    // Fast connect lease
+    JsonObjectConst lease = doc["lease"];
+    WifiLeaseCache& cache = networkState.lease;
+    cache.valid = false;
+
+    if (!lease.isNull()) {
+        int mac[6];
+        const char* bssid = lease["bssid"] | "";
+
+        if (sscanf(bssid, "%x:%x:%x:%x:%x:%x", &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]) == 6) {
+            for (int i = 0; i < 6; i++) cache.bssid[i] = (uint8_t)mac[i];
+
+            cache.ssid = lease["ssid"] | "";
+            cache.channel = lease["channel"] | 0;
+            cache.valid = cache.channel > 0;
+        }
+    }
+
     return true;
 }
 
@@ -120,6 +129,18 @@ void SystemManager::writeConfig() {
     doc["setup_complete"] = systemState.setup_complete;
     doc["spotify_linked"] = systemState.spotify_linked;
 
+    const WifiLeaseCache& cache = networkState.lease;
+    if (cache.valid) {
+        char bssid[18];
+        snprintf(bssid, sizeof(bssid), "%02X:%02X:%02X:%02X:%02X:%02X",
+            cache.bssid[0], cache.bssid[1], cache.bssid[2], cache.bssid[3], cache.bssid[4], cache.bssid[5]);
+
+        JsonObject lease = doc["lease"].to<JsonObject>();
+        lease["ssid"] = cache.ssid;
+        lease["bssid"] = bssid;
+        lease["channel"] = cache.channel;
+    }
+
     if (serializeJson(doc, file) == 0) {
         Serial.println("Failed to write to file - config");
         file.close();
@@ -133,6 +154,7 @@ void SystemManager::writeConfig() {
 void SystemManager::resetConfig() {
     LittleFS.remove("/config.json");
 
+    networkState.lease = WifiLeaseCache();
     systemState.setup_complete = false;
     systemState.spotify_linked = false; // Todo: Need this?
 }
@@ -177,7 +199,8 @@ bool SystemManager::loadSpotifyTokens() {
     }
 
     spotifyState.refresh_token = doc["spotify_refresh_token"].as<String>();
-    //spotifyState.a = doc["spotify_client_secret"].as<String>();
+    spotifyState.access_token = doc["spotify_access_token"] | "";
+    spotifyState.access_token_expiry = doc["spotify_access_token_expiry"] | 0u;
 
     return true;
 }
@@ -191,6 +214,8 @@ void SystemManager::writeSpotifyTokens() {
 
     JsonDocument doc;
     doc["spotify_refresh_token"] = spotifyState.refresh_token;
+    doc["spotify_access_token"] = spotifyState.access_token;
+    doc["spotify_access_token_expiry"] = spotifyState.access_token_expiry;
 
     if (serializeJson(doc, file) == 0) {
         Serial.println("Failed to write to file - tokens");
@@ -205,6 +230,9 @@ void SystemManager::writeSpotifyTokens() {
 void SystemManager::resetSpotifyTokens() {
     LittleFS.remove("/tokens.json");
     spotifyState.refresh_token = "";
+    spotifyState.access_token = "";
+    spotifyState.access_token_expiry = 0;
+    spotifyState.access_token_issued_ms = 0;
 }
 
 
@@ -216,7 +244,7 @@ void SystemManager::setBacklight(bool on) {
     Wire.write(on ? 0x0F : 0x00);
 
     Wire.endTransmission();
-    Serial.printf("System: Backlight %s\n", on ? "ON" : "OFF");
+    TRACE(TRACE_BACKLIGHT, on);
 }
 
 
@@ -224,6 +252,7 @@ void SystemManager::setBacklight(bool on) {
 // --- Sleep Mode ---
 void SystemManager::enterSleepMode() {
     Serial.println("System: Entering sleep mode");
+    wake_pending = false;
 
     // Dim Backlight
     setBacklight(false);
@@ -237,11 +266,8 @@ void SystemManager::exitSleepMode() {
     // Turn Backlight on
     setBacklight(true);
 
+    // Built from the current state, so nothing needs flagging for a refresh
     UIManager::getInstance().showMainPlayer();
 
-    // Refresh UI
-    spotifyState.needs_art_update = true;
-    spotifyState.needs_text_update = true;
-
     Serial.println("System: Exited sleep mode");
 }
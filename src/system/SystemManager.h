@@ -7,6 +7,7 @@
 
 #include <Arduino.h>
 #include <lvgl.h>
+#include <atomic>
 
 class SystemManager {
 public:
@@ -16,7 +17,6 @@ public:
     }
 
     void init();
-    void update();
 
 
     // For Config.json
@@ -39,15 +39,18 @@ public:
 
     // Sleep / Wake
     void enterSleepMode();
-    void exitSleepMode();
+    void exitSleepMode();           // Graphics task only
+
+    // Any task - the graphics task picks it up with takeWake() and runs exitSleepMode()
+    void requestWake() { wake_pending = true; }
+    bool takeWake() { return wake_pending.exchange(false); }
 
 
 private:
+    std::atomic<bool> wake_pending{false};
 
     SystemManager() {}
 
-    bool connectionRequested = false;
-
 
     SystemManager(const SystemManager&) = delete;
     void operator=(const SystemManager&) = delete;
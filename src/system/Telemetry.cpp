@@ -0,0 +1,205 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "Telemetry.h"
+
+#include <esp_heap_caps.h>
+
+void Telemetry::watchTask(TaskHandle_t handle) {
+    if (handle == nullptr || watched_count >= TELEMETRY_MAX_TASKS) return;
+    watched[watched_count++] = handle;
+}
+
+void Telemetry::update() {
+    if (last_sample_ms != 0 && millis() - last_sample_ms < TELEMETRY_INTERVAL_MS) return;
+
+    sample();
+    printReport();
+}
+
+void Telemetry::sample() {
+    TelemetrySnapshot next;
+    next.at_ms = millis();
+
+    sampleTasks(next);
+    readHeap(next.internal, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    readHeap(next.psram, MALLOC_CAP_SPIRAM);
+
+    uint32_t frames = frame_count.exchange(0);
+    uint32_t frame_us = frame_us_total.exchange(0);
+    next.frames.count = frames;
+    next.frames.avg_us = frames ? frame_us / frames : 0;
+    next.frames.max_us = frame_us_max.exchange(0);
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    snapshot = next;
+    xSemaphoreGive(mutex);
+
+    last_sample_ms = next.at_ms ? next.at_ms : 1;
+}
+
+void Telemetry::sampleTasks(TelemetrySnapshot &next) {
+#if configUSE_TRACE_FACILITY
+    static TaskStatus_t status[TELEMETRY_MAX_TASKS];
+    uint32_t total_run_time = 0;
+    UBaseType_t count = uxTaskGetSystemState(status, TELEMETRY_MAX_TASKS, &total_run_time);
+    if (count == 0) {
+        Serial.printf("Telemetry: More than %d tasks, raise TELEMETRY_MAX_TASKS\n", TELEMETRY_MAX_TASKS);
+        return;
+    }
+
+#if configGENERATE_RUN_TIME_STATS
+    uint32_t total_delta = total_run_time - last_total_run_time;
+    next.cpu_valid = last_total_run_time != 0 && total_delta > 0;
+    last_total_run_time = total_run_time;
+#endif
+
+    for (UBaseType_t i = 0; i < count; i++) {
+        TaskTelemetry& t = next.tasks[next.task_count++];
+        strlcpy(t.name, status[i].pcTaskName, sizeof(t.name));
+        t.stack_free = status[i].usStackHighWaterMark;
+        t.priority = status[i].uxCurrentPriority;
+        t.number = status[i].xTaskNumber;
+        t.run_time = 0;
+        t.cpu_permille = 0;
+
+#if configGENERATE_RUN_TIME_STATS
+        t.run_time = status[i].ulRunTimeCounter;
+        if (!next.cpu_valid) continue;
+
+        // Against the same task last time - a new one has only run since it started
+        uint32_t delta = t.run_time;
+        for (uint8_t j = 0; j < snapshot.task_count; j++) {
+            if (snapshot.tasks[j].number == t.number) {
+                delta = t.run_time - snapshot.tasks[j].run_time;
+                break;
+            }
+        }
+
+        t.cpu_permille = (uint16_t)((uint64_t)delta * 1000 / ((uint64_t)total_delta * portNUM_PROCESSORS));
+
+        // Whatever the idle task didn't get, the core was busy for
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            if (status[i].xHandle != xTaskGetIdleTaskHandleForCPU(core)) continue;
+            uint32_t idle = (uint32_t)((uint64_t)delta * 1000 / total_delta);
+            next.core_load_permille[core] = idle >= 1000 ? 0 : 1000 - idle;
+        }
+#endif
+    }
+#else
+    // No task list without the trace facility - just the ones we were told about
+    for (uint8_t i = 0; i < watched_count; i++) {
+        TaskTelemetry& t = next.tasks[next.task_count++];
+        strlcpy(t.name, pcTaskGetName(watched[i]), sizeof(t.name));
+        t.stack_free = uxTaskGetStackHighWaterMark(watched[i]);
+        t.priority = uxTaskPriorityGet(watched[i]);
+        t.number = i;
+        t.run_time = 0;
+        t.cpu_permille = 0;
+    }
+#endif
+}
+
+void Telemetry::readHeap(HeapTelemetry &out, uint32_t caps) {
+    out.total = heap_caps_get_total_size(caps);
+    out.free = heap_caps_get_free_size(caps);
+    out.min_free = heap_caps_get_minimum_free_size(caps);
+    out.largest = heap_caps_get_largest_free_block(caps);
+}
+
+void Telemetry::taskFinished() {
+    const char* name = pcTaskGetName(NULL);
+    uint32_t stack_free = uxTaskGetStackHighWaterMark(NULL);
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+
+    FinishedTaskTelemetry* slot = nullptr;
+    for (uint8_t i = 0; i < finished_count; i++) {
+        if (strncmp(finished[i].name, name, TELEMETRY_NAME_LEN - 1) == 0) {
+            slot = &finished[i];
+            break;
+        }
+    }
+
+    if (slot == nullptr && finished_count < TELEMETRY_MAX_FINISHED) {
+        slot = &finished[finished_count++];
+        strlcpy(slot->name, name, sizeof(slot->name));
+        slot->stack_free = stack_free;
+        slot->runs = 0;
+    }
+
+    if (slot) {
+        if (stack_free < slot->stack_free) slot->stack_free = stack_free;
+        slot->runs++;
+    }
+
+    xSemaphoreGive(mutex);
+}
+
+void Telemetry::recordFrame(uint32_t us) {
+    frame_count.fetch_add(1, std::memory_order_relaxed);
+    frame_us_total.fetch_add(us, std::memory_order_relaxed);
+
+    // sample() resets it from another task - a failed swap reloads and tries again
+    uint32_t seen = frame_us_max.load(std::memory_order_relaxed);
+    while (us > seen && !frame_us_max.compare_exchange_weak(seen, us, std::memory_order_relaxed)) {}
+}
+
+void Telemetry::getSnapshot(TelemetrySnapshot &out) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    out = snapshot;
+    xSemaphoreGive(mutex);
+}
+
+uint8_t Telemetry::getFinished(FinishedTaskTelemetry *out, uint8_t max) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint8_t count = finished_count < max ? finished_count : max;
+    memcpy(out, finished, count * sizeof(FinishedTaskTelemetry));
+    xSemaphoreGive(mutex);
+    return count;
+}
+
+static void printHeap(const char* name, const HeapTelemetry& heap) {
+    uint32_t frag = heap.free ? 100 - (uint32_t)((uint64_t)heap.largest * 100 / heap.free) : 0;
+    Serial.printf("Telemetry:   %-8s free %7u / %7u B, min %7u B, largest %7u B (%u%% fragmented)\n",
+        name, heap.free, heap.total, heap.min_free, heap.largest, frag);
+}
+
+void Telemetry::printReport() {
+    static TelemetrySnapshot report;
+    getSnapshot(report);
+
+    Serial.printf("Telemetry: --- %u s ---\n", report.at_ms / 1000);
+
+    for (uint8_t i = 0; i < report.task_count; i++) {
+        const TaskTelemetry& t = report.tasks[i];
+        if (report.cpu_valid) {
+            Serial.printf("Telemetry:   %-16s stack free %6u B, prio %2u, cpu %3u.%u%%\n",
+                t.name, t.stack_free, t.priority, t.cpu_permille / 10, t.cpu_permille % 10);
+        } else {
+            Serial.printf("Telemetry:   %-16s stack free %6u B, prio %2u\n", t.name, t.stack_free, t.priority);
+        }
+    }
+
+    if (report.cpu_valid) {
+        Serial.printf("Telemetry:   core load %u.%u%% / %u.%u%%\n",
+            report.core_load_permille[0] / 10, report.core_load_permille[0] % 10,
+            report.core_load_permille[1] / 10, report.core_load_permille[1] % 10);
+    }
+
+    FinishedTaskTelemetry done[TELEMETRY_MAX_FINISHED];
+    uint8_t done_count = getFinished(done, TELEMETRY_MAX_FINISHED);
+    for (uint8_t i = 0; i < done_count; i++) {
+        Serial.printf("Telemetry:   %-16s stack free %6u B at worst over %u runs\n",
+            done[i].name, done[i].stack_free, done[i].runs);
+    }
+
+    if (report.frames.count) {
+        Serial.printf("Telemetry:   frames %u, avg %u us, max %u us\n",
+            report.frames.count, report.frames.avg_us, report.frames.max_us);
+    }
+
+    printHeap("internal", report.internal);
+    printHeap("psram", report.psram);
+}
@@ -0,0 +1,111 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#define TELEMETRY_INTERVAL_MS 30000
+#define TELEMETRY_MAX_TASKS 32
+#define TELEMETRY_MAX_FINISHED 8
+#define TELEMETRY_NAME_LEN 16
+
+struct TaskTelemetry {
+    char name[TELEMETRY_NAME_LEN];
+    uint32_t stack_free;        // Bytes never touched since the task started
+    uint16_t cpu_permille;      // Share of both cores since the last sample
+    uint8_t priority;
+    uint32_t number;            // FreeRTOS task number, matches up samples
+    uint32_t run_time;          // Raw counter, for the next delta
+};
+
+struct FinishedTaskTelemetry {
+    char name[TELEMETRY_NAME_LEN];
+    uint32_t stack_free;        // Lowest seen across every run
+    uint32_t runs;
+};
+
+struct HeapTelemetry {
+    uint32_t total;
+    uint32_t free;
+    uint32_t min_free;          // Low-water mark since boot
+    uint32_t largest;           // Biggest single block that can be allocated
+};
+
+struct FrameTelemetry {
+    uint32_t count;             // Frames since the last sample
+    uint32_t avg_us;            // UI update + lv_timer_handler
+    uint32_t max_us;
+};
+
+struct TelemetrySnapshot {
+    uint32_t at_ms = 0;
+    bool cpu_valid = false;     // Needs configGENERATE_RUN_TIME_STATS and a previous sample
+    uint16_t core_load_permille[portNUM_PROCESSORS] = {};
+    uint8_t task_count = 0;
+    TaskTelemetry tasks[TELEMETRY_MAX_TASKS];
+    HeapTelemetry internal = {};
+    HeapTelemetry psram = {};
+    FrameTelemetry frames = {};
+};
+
+// Samples stack high-water marks, FreeRTOS run-time stats and the internal / PSRAM
+// heaps every TELEMETRY_INTERVAL_MS and logs them, so stacks and buffers can be sized
+// from real numbers. Short-lived tasks report their stack on the way out
+class Telemetry {
+public:
+    static Telemetry& getInstance() {
+        static Telemetry instance;
+        return instance;
+    }
+
+    // Long-lived tasks to sample when the scheduler can't list them itself
+    void watchTask(TaskHandle_t handle);
+
+    // Called from the system task, samples once the interval has passed
+    void update();
+    void sample();
+    void printReport();
+
+    // Called by a task just before it deletes itself
+    void taskFinished();
+
+    // Called by the graphics task with how long a frame's work took
+    void recordFrame(uint32_t us);
+
+    static void readHeap(HeapTelemetry& out, uint32_t caps);
+
+    // Copy of the last sample
+    void getSnapshot(TelemetrySnapshot& out);
+    uint8_t getFinished(FinishedTaskTelemetry* out, uint8_t max);
+
+private:
+    Telemetry() { mutex = xSemaphoreCreateMutex(); }
+
+    SemaphoreHandle_t mutex = nullptr;
+    TelemetrySnapshot snapshot;
+    uint32_t last_total_run_time = 0;
+    uint32_t last_sample_ms = 0;
+
+    TaskHandle_t watched[TELEMETRY_MAX_TASKS] = {};
+    uint8_t watched_count = 0;
+
+    FinishedTaskTelemetry finished[TELEMETRY_MAX_FINISHED];
+    uint8_t finished_count = 0;
+
+    std::atomic<uint32_t> frame_count{0};
+    std::atomic<uint32_t> frame_us_total{0};
+    std::atomic<uint32_t> frame_us_max{0};
+
+    void sampleTasks(TelemetrySnapshot& next);
+
+    Telemetry(const Telemetry&) = delete;
+    void operator=(const Telemetry&) = delete;
+};
+
+
+
+#endif //TELEMETRY_H
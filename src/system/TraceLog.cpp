@@ -0,0 +1,113 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "TraceLog.h"
+
+#include <algorithm>
+
+#define TRACE_BATCH 32
+#define TRACE_LINE_BUFFER 512
+
+void TraceLog::begin() {
+#if TRACE_LOG_STREAM
+    xTaskCreatePinnedToCore(drainTask, "TraceDrain", 4096, NULL, 1, NULL, 0);
+#endif
+}
+
+size_t TraceLog::read(TraceRecord *out, size_t max) {
+    xSemaphoreTake(read_mutex, portMAX_DELAY);
+
+    size_t count = 0;
+    for (uint8_t core = 0; core < TRACE_CORES; core++) {
+        Ring& ring = rings[core];
+        uint32_t head = ring.head.load(std::memory_order_acquire);
+
+        // Writers lapped the reader - the oldest are gone
+        if (head - ring.tail > TRACE_RING_SIZE) {
+            dropped += head - ring.tail - TRACE_RING_SIZE;
+            ring.tail = head - TRACE_RING_SIZE;
+        }
+
+        while (ring.tail != head && count < max) {
+            Slot& slot = ring.slots[ring.tail & (TRACE_RING_SIZE - 1)];
+            uint32_t want = ring.tail + 1;
+
+            uint32_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq != want) {
+                // Still being written - picked up next time
+                if (seq == 0 || seq < want) break;
+
+                // Already reused by a newer event
+                dropped++;
+                ring.tail++;
+                continue;
+            }
+
+            TraceRecord& r = out[count];
+            r.t_us = slot.t_us;
+            r.id = slot.id;
+            r.core = core;
+            r.a = slot.a;
+            r.b = slot.b;
+
+            // Reused while it was being copied
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != want) {
+                dropped++;
+                ring.tail++;
+                continue;
+            }
+
+            count++;
+            ring.tail++;
+        }
+    }
+
+    xSemaphoreGive(read_mutex);
+
+    // Interleave the two cores
+    std::sort(out, out + count, [](const TraceRecord& x, const TraceRecord& y) {
+        return (int32_t)(x.t_us - y.t_us) < 0;
+    });
+    return count;
+}
+
+// One line per event so the stream can share the console with Serial logging
+void TraceLog::print(const TraceRecord *records, size_t count) {
+    char buf[TRACE_LINE_BUFFER];
+    size_t len = 0;
+
+    if (dropped != reported_dropped) {
+        len += snprintf(buf + len, sizeof(buf) - len, "~D %u\n", dropped - reported_dropped);
+        reported_dropped = dropped;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (sizeof(buf) - len < 40) {
+            Serial.write((const uint8_t*)buf, len);
+            len = 0;
+        }
+
+        const TraceRecord& r = records[i];
+        len += snprintf(buf + len, sizeof(buf) - len, "~T%u %08x %04x %08x %08x\n",
+            r.core, r.t_us, r.id, r.a, r.b);
+    }
+
+    if (len) Serial.write((const uint8_t*)buf, len);
+}
+
+void TraceLog::dump() {
+    TraceRecord batch[TRACE_BATCH];
+    size_t count;
+    while ((count = read(batch, TRACE_BATCH)) > 0) print(batch, count);
+}
+
+void TraceLog::drainTask(void *pvParameters) {
+    TraceLog& trace = getInstance();
+
+    for (;;) {
+        trace.dump();
+        vTaskDelay(pdMS_TO_TICKS(TRACE_DRAIN_MS));
+    }
+}
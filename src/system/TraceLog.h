@@ -0,0 +1,126 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef TRACELOG_H
+#define TRACELOG_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#define TRACE_RING_SIZE 128         // Events per core, power of two
+#define TRACE_DRAIN_MS 100
+#define TRACE_CORES 2
+
+// Production builds can set this to 0 - events are still kept for dump()
+#ifndef TRACE_LOG_STREAM
+#define TRACE_LOG_STREAM 1
+#endif
+
+// Event ids. tools/trace_decode.py reads the comments as format strings:
+// {a} / {b} payload, {as} / {bs} as signed, {ah} / {al} 16-bit halves of a, python format specs allowed
+enum TraceEventId : uint16_t {
+    TRACE_NONE,
+    TRACE_POLL,                 // Poll HTTP {as} in {b} ms
+    TRACE_POLL_TOKEN_REJECTED,  // Poll 401, refreshing token
+    TRACE_POLL_RETRY,           // Poll failed HTTP {as}, retrying
+    TRACE_POLL_ERROR,           // Poll error HTTP {as}
+    TRACE_TRACK_CHANGED,        // Track changed, new art {a}
+    TRACE_NOTHING_PLAYING,      // Nothing playing
+    TRACE_UI_TRACK_TEXT,        // UI track text updated
+    TRACE_UI_ART_REQUEST,       // UI art requested at {a}px
+    TRACE_UI_ASSET_FETCH,       // UI asset {a} not baked, fetching source
+    TRACE_UI_BACKGROUND,        // UI background 0x{a:06X}
+    TRACE_UI_DEVICE_NAME,       // UI device name updated
+    TRACE_UI_SCREEN_COST,       // UI screen built - {ah} objects, {al} local style props, {bs} B heap
+    TRACE_ART_CANCELLED,        // Art decode cancelled, no art widget
+    TRACE_ART_DECODE_FAILED,    // Art decode failed
+    TRACE_ART_DECODED,          // Art decoded (fused {ah}) at {al}px in {b} us
+    TRACE_ART_PSRAM,            // Art PSRAM ~{a} B est. (unfused ~{b} B)
+    TRACE_ART_PRESENTED,        // Art presented at {a}px
+    TRACE_ART_FRAME_BAKED,      // Art frame baked in {a} us
+    TRACE_BACKLIGHT,            // Backlight {a}
+    TRACE_RATE_DEFERRED,        // Rate limited, priority {a} deferred {b} ms
+    TRACE_RATE_THROTTLED,       // Spotify 429, holding requests for {a} ms
+    TRACE_ART_STALE,            // Art dropped, requested for an older track
+    TRACE_EVENT_COUNT
+};
+
+struct TraceRecord {
+    uint32_t t_us;
+    uint16_t id;
+    uint8_t core;
+    uint32_t a;
+    uint32_t b;
+};
+
+// Binary event log for the hot paths. Each core writes its own ring without taking a
+// lock - a slot is claimed with one atomic add and published by its sequence number,
+// so a task preempted mid-write only holds back the reader, never another writer.
+// A low priority task streams the rings out as hex lines for tools/trace_decode.py
+class TraceLog {
+public:
+    static TraceLog& getInstance() {
+        static TraceLog instance;
+        return instance;
+    }
+
+    // Starts the drain task when streaming
+    void begin();
+
+    void log(TraceEventId id, uint32_t a = 0, uint32_t b = 0) {
+        Ring& ring = rings[xPortGetCoreID()];
+        uint32_t n = ring.head.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = ring.slots[n & (TRACE_RING_SIZE - 1)];
+
+        slot.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.t_us = micros();
+        slot.id = id;
+        slot.a = a;
+        slot.b = b;
+        slot.seq.store(n + 1, std::memory_order_release);
+    }
+
+    // Copies out whatever hasn't been read yet, both cores merged oldest first
+    size_t read(TraceRecord* out, size_t max);
+
+    // Prints everything still buffered, for builds that don't stream
+    void dump();
+
+    uint32_t getDropped() const { return dropped; }
+
+private:
+    TraceLog() { read_mutex = xSemaphoreCreateMutex(); }
+
+    struct Slot {
+        std::atomic<uint32_t> seq{0};   // Event number + 1 once written, 0 while being written
+        uint32_t t_us = 0;
+        uint16_t id = 0;
+        uint32_t a = 0;
+        uint32_t b = 0;
+    };
+
+    struct Ring {
+        std::atomic<uint32_t> head{0};  // Next event number
+        uint32_t tail = 0;              // Next event the reader wants
+        Slot slots[TRACE_RING_SIZE];
+    };
+
+    Ring rings[TRACE_CORES];
+    uint32_t dropped = 0;
+    uint32_t reported_dropped = 0;
+    SemaphoreHandle_t read_mutex = nullptr;
+
+    static void drainTask(void* pvParameters);
+    void print(const TraceRecord* records, size_t count);
+
+    TraceLog(const TraceLog&) = delete;
+    void operator=(const TraceLog&) = delete;
+};
+
+#define TRACE(id, ...) TraceLog::getInstance().log(id, ##__VA_ARGS__)
+
+
+
+#endif //TRACELOG_H
@@ -0,0 +1,134 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "ArtFrame.h"
+
+#include "system/TraceLog.h"
+
+static const int R = ART_CORNER_RADIUS;
+
+// Fraction of a pixel inside a circle of the given radius, 0-255
+static uint8_t coverage(float radius, float dist) {
+    float c = radius - dist + 0.5f;
+    if (c <= 0) return 0;
+    if (c >= 1) return 255;
+    return (uint8_t)(c * 255.0f);
+}
+
+void ArtFrame::buildTables() {
+    for (int y = 0; y < R; y++) {
+        for (int x = 0; x < R; x++) {
+            float dx = R - (x + 0.5f);
+            float dy = R - (y + 0.5f);
+            float dist = sqrtf(dx * dx + dy * dy);
+
+            uint8_t outer = coverage(R, dist);
+            uint8_t in = coverage(R - 1, dist);
+            inner[y * R + x] = in;
+            ring[y * R + x] = outer - in;
+        }
+    }
+    tables_built = true;
+}
+
+void ArtFrame::capture(lv_color_t* px, uint16_t width, uint16_t height) {
+    if (!tables_built) buildTables();
+
+    pixels = px;
+    w = width;
+    h = height;
+    if (!pixels || w < 2 * R || h < 2 * R) {
+        pixels = nullptr;
+        return;
+    }
+
+    size_t needed = 2 * (size_t)w + 2 * (size_t)h + 4 * R * R;
+    if (saved_len != needed) {
+        free(saved);
+        saved = (lv_color_t*)ps_malloc(needed * sizeof(lv_color_t));
+        saved_len = saved ? needed : 0;
+    }
+    if (!saved) {
+        pixels = nullptr;
+        return;
+    }
+
+    copyFrame(false);
+}
+
+// Every pixel bake() can touch: the outer rows / columns and the four corner squares
+void ArtFrame::copyFrame(bool restore) {
+    lv_color_t* slot = saved;
+    auto copy = [&](lv_color_t& px) {
+        if (restore) px = *slot;
+        else *slot = px;
+        slot++;
+    };
+
+    for (int x = 0; x < w; x++) copy(pixels[x]);
+    for (int x = 0; x < w; x++) copy(pixels[(h - 1) * w + x]);
+    for (int y = 0; y < h; y++) copy(pixels[y * w]);
+    for (int y = 0; y < h; y++) copy(pixels[y * w + w - 1]);
+
+    for (int y = 0; y < R; y++) {
+        for (int x = 0; x < R; x++) {
+            copy(pixels[y * w + x]);
+            copy(pixels[y * w + (w - 1 - x)]);
+            copy(pixels[(h - 1 - y) * w + x]);
+            copy(pixels[(h - 1 - y) * w + (w - 1 - x)]);
+        }
+    }
+}
+
+void ArtFrame::bake(lv_color_t bg) {
+    if (!pixels) return;
+
+    uint32_t start = micros();
+    copyFrame(true);
+
+    lv_color_t white = lv_color_white();
+
+    // Straight edges - the border over the art
+    for (int x = R; x < w - R; x++) {
+        pixels[x] = lv_color_mix(white, pixels[x], ART_BORDER_OPA);
+        lv_color_t& bottom = pixels[(h - 1) * w + x];
+        bottom = lv_color_mix(white, bottom, ART_BORDER_OPA);
+    }
+    for (int y = R; y < h - R; y++) {
+        lv_color_t& left = pixels[y * w];
+        lv_color_t& right = pixels[y * w + w - 1];
+        left = lv_color_mix(white, left, ART_BORDER_OPA);
+        right = lv_color_mix(white, right, ART_BORDER_OPA);
+    }
+
+    // Corners - art inside, border on the arc, background outside
+    for (int y = 0; y < R; y++) {
+        for (int x = 0; x < R; x++) {
+            uint8_t in = inner[y * R + x];
+            uint8_t arc = ring[y * R + x];
+            uint16_t covered = in + arc;
+
+            lv_color_t* corner[4] = {
+                &pixels[y * w + x],
+                &pixels[y * w + (w - 1 - x)],
+                &pixels[(h - 1 - y) * w + x],
+                &pixels[(h - 1 - y) * w + (w - 1 - x)],
+            };
+
+            for (lv_color_t* px : corner) {
+                if (covered == 0) {
+                    *px = bg;
+                    continue;
+                }
+                if (in == 255) continue;
+
+                lv_color_t edge = lv_color_mix(white, *px, ART_BORDER_OPA);
+                lv_color_t fg = lv_color_mix(edge, *px, (uint8_t)(arc * 255 / covered));
+                *px = lv_color_mix(fg, bg, (uint8_t)(covered > 255 ? 255 : covered));
+            }
+        }
+    }
+
+    TRACE(TRACE_ART_FRAME_BAKED, micros() - start);
+}
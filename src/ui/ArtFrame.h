@@ -0,0 +1,47 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef ARTFRAME_H
+#define ARTFRAME_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+#define ART_CORNER_RADIUS 15
+#define ART_BORDER_OPA LV_OPA_10
+
+// Bakes the album art's rounded corners and 1px border straight into its pixels,
+// so LVGL can draw it as a plain opaque blit instead of masking every redraw.
+// The untouched edge pixels are kept so it can be re-baked for a new background
+class ArtFrame {
+public:
+    // Takes a copy of the pixels the frame will overwrite
+    void capture(lv_color_t* pixels, uint16_t w, uint16_t h);
+
+    // Restores the originals, then blends corners against bg and draws the border
+    void bake(lv_color_t bg);
+
+    bool isCaptured() const { return pixels != nullptr; }
+    void release() { pixels = nullptr; }
+
+private:
+    lv_color_t* pixels = nullptr;
+    uint16_t w = 0;
+    uint16_t h = 0;
+
+    lv_color_t* saved = nullptr;    // Edge rows, edge columns, then corner squares
+    size_t saved_len = 0;
+
+    // Per-pixel coverage for the top-left corner, mirrored for the others
+    uint8_t inner[ART_CORNER_RADIUS * ART_CORNER_RADIUS];
+    uint8_t ring[ART_CORNER_RADIUS * ART_CORNER_RADIUS];
+    bool tables_built = false;
+
+    void buildTables();
+    void copyFrame(bool restore);
+};
+
+
+
+#endif //ARTFRAME_H
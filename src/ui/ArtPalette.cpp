@@ -0,0 +1,88 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "ArtPalette.h"
+
+#include <string.h>
+
+#define PALETTE_MIN_LUMA 30
+#define PALETTE_MAX_LUMA 225
+
+void PaletteBuilder::reset() {
+    memset(count, 0, sizeof(count));
+    memset(sum_r, 0, sizeof(sum_r));
+    memset(sum_g, 0, sizeof(sum_g));
+    memset(sum_b, 0, sizeof(sum_b));
+    total = 0;
+}
+
+void PaletteBuilder::add(const uint16_t* pixels, int n) {
+    for (int i = 0; i < n; i++) {
+        uint16_t c = pixels[i];
+        uint8_t r = (c >> 11) & 0x1F;
+        uint8_t g = (c >> 5) & 0x3F;
+        uint8_t b = c & 0x1F;
+
+        int bin = ((r >> 2) << 6) | ((g >> 3) << 3) | (b >> 2);
+        count[bin]++;
+        sum_r[bin] += r;
+        sum_g[bin] += g;
+        sum_b[bin] += b;
+    }
+    total += n;
+}
+
+static PaletteColour scaled(const PaletteColour& c, float f) {
+    PaletteColour out;
+    out.r = (uint8_t)(c.r * f);
+    out.g = (uint8_t)(c.g * f);
+    out.b = (uint8_t)(c.b * f);
+    return out;
+}
+
+bool PaletteBuilder::build(ArtPalette& out) const {
+    out = ArtPalette();
+    if (total == 0) return false;
+
+    // Most common colour weighted by saturation, skipping near black / white
+    int best = -1;
+    float best_score = 0;
+    int common = 0;
+
+    for (int bin = 0; bin < BINS; bin++) {
+        if (count[bin] == 0) continue;
+        if (count[bin] > count[common]) common = bin;
+
+        uint8_t r = sum_r[bin] * 255 / (31 * count[bin]);
+        uint8_t g = sum_g[bin] * 255 / (63 * count[bin]);
+        uint8_t b = sum_b[bin] * 255 / (31 * count[bin]);
+
+        uint8_t hi = r > g ? (r > b ? r : b) : (g > b ? g : b);
+        uint8_t lo = r < g ? (r < b ? r : b) : (g < b ? g : b);
+        float luma = 0.299f * r + 0.587f * g + 0.114f * b;
+        if (luma < PALETTE_MIN_LUMA || luma > PALETTE_MAX_LUMA) continue;
+
+        float saturation = hi ? (float)(hi - lo) / hi : 0;
+        float score = count[bin] * (0.1f + saturation * saturation);
+        if (score > best_score) {
+            best_score = score;
+            best = bin;
+        }
+    }
+    if (best < 0) best = common;
+
+    PaletteColour vibrant;
+    vibrant.r = sum_r[best] * 255 / (31 * count[best]);
+    vibrant.g = sum_g[best] * 255 / (63 * count[best]);
+    vibrant.b = sum_b[best] * 255 / (31 * count[best]);
+
+    out.vibrant = vibrant;
+    out.darker_1 = scaled(vibrant, 0.7f);
+    out.darker_2 = scaled(vibrant, 0.45f);
+    out.lighter_1.r = vibrant.r + (255 - vibrant.r) * 3 / 10;
+    out.lighter_1.g = vibrant.g + (255 - vibrant.g) * 3 / 10;
+    out.lighter_1.b = vibrant.b + (255 - vibrant.b) * 3 / 10;
+    out.valid = true;
+    return true;
+}
@@ -0,0 +1,46 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef ARTPALETTE_H
+#define ARTPALETTE_H
+
+#include <stdint.h>
+
+struct PaletteColour {
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+
+    uint32_t to0x() const { return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b; }
+};
+
+struct ArtPalette {
+    bool valid = false;
+    PaletteColour vibrant;
+    PaletteColour darker_1;
+    PaletteColour darker_2;
+    PaletteColour lighter_1;
+};
+
+// Histogram of RGB565 pixels fed in as the art is scaled, so the palette
+// comes out of the same pass rather than a second download
+class PaletteBuilder {
+public:
+    void reset();
+    void add(const uint16_t* pixels, int count);
+    bool build(ArtPalette& out) const;
+
+private:
+    // 3 bits per channel, with running sums so each bin gives its true mean
+    static const int BINS = 512;
+    uint32_t count[BINS];
+    uint32_t sum_r[BINS];
+    uint32_t sum_g[BINS];
+    uint32_t sum_b[BINS];
+    uint32_t total = 0;
+};
+
+
+
+#endif //ARTPALETTE_H
@@ -0,0 +1,77 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "ArtPipeline.h"
+
+#include "ArtScaler.h"
+#include "JpegDecoder.h"
+
+static PaletteBuilder palette_builder;
+static ArtPipelineStats last_stats;
+
+static void paletteRow(const uint16_t* row, int width, void* ctx) {
+    ((PaletteBuilder*)ctx)->add(row, width);
+}
+
+static void scaleStrip(const uint16_t* strip, uint16_t y, uint16_t rows, uint16_t width, void* ctx) {
+    ArtScaleStream* stream = (ArtScaleStream*)ctx;
+    for (uint16_t r = 0; r < rows; r++) stream->pushRow(&strip[r * width]);
+}
+
+bool ArtPipeline::run(const uint8_t* jpg, size_t len, uint16_t* dst, int target,
+                      ArtPalette& palette, ArtPipelineStats& stats) {
+    uint32_t start = micros();
+    stats = ArtPipelineStats();
+
+    JpegInfo info;
+    if (!dst || !JpegDecoder::parse(jpg, len, info)) return false;
+
+    // Aspect-fit on the longer side, centred on black
+    int longest = info.width > info.height ? info.width : info.height;
+    int dw = info.width * target / longest;
+    int dh = info.height * target / longest;
+    uint32_t dst_bytes = (uint32_t)target * target * sizeof(uint16_t);
+    if (dw != target || dh != target) {
+        memset(dst, 0, dst_bytes);
+        stats.psram_bytes_est += dst_bytes;
+    }
+
+    uint16_t* origin = dst + ((target - dh) / 2) * target + (target - dw) / 2;
+    ArtScaleMode mode = ArtScaler::pickMode(longest, target);
+    uint32_t full_bytes = (uint32_t)info.width * info.height * sizeof(uint16_t);
+
+    palette_builder.reset();
+    ArtScaleStream stream;
+    if (!stream.begin(info.width, info.height, origin, dw, dh, target, mode)) return false;
+    stream.setRowCallback(paletteRow, &palette_builder);
+
+    bool ok;
+    if (info.restart_interval > 0) {
+        // Restart markers - decode the whole bitmap on both cores, then scale it
+        uint16_t* full = (uint16_t*)ps_malloc(full_bytes);
+        ok = full && JpegDecoder::decode(jpg, len, full);
+        if (ok) {
+            for (int y = 0; y < info.height; y++) stream.pushRow(&full[y * info.width]);
+        }
+        free(full);
+        stats.psram_bytes_est += len + full_bytes * 2 + (uint32_t)dw * dh * sizeof(uint16_t);
+    } else {
+        ok = JpegDecoder::decodeStrips(jpg, len, scaleStrip, &stream);
+        stats.fused = true;
+        stats.psram_bytes_est += len + (uint32_t)dw * dh * sizeof(uint16_t);
+    }
+
+    ok = ok && stream.isComplete();
+    if (ok) palette_builder.build(palette);
+
+    // JPEG in, full bitmap out and back in, scaled image out
+    stats.unfused_psram_bytes_est = len + full_bytes * 2 + (uint32_t)dw * dh * sizeof(uint16_t);
+    stats.us = micros() - start;
+    if (ok) last_stats = stats;
+    return ok;
+}
+
+ArtPipelineStats ArtPipeline::getLastStats() {
+    return last_stats;
+}
@@ -0,0 +1,37 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef ARTPIPELINE_H
+#define ARTPIPELINE_H
+
+#include <Arduino.h>
+
+#include "ArtPalette.h"
+
+struct ArtPipelineStats {
+    uint32_t us = 0;
+    bool fused = false;
+
+    // Estimated PSRAM traffic, worked out from the buffer sizes each path reads and writes
+    uint32_t psram_bytes_est = 0;
+    uint32_t unfused_psram_bytes_est = 0;   // What the decode -> full bitmap -> scale path would move
+};
+
+// JPEG -> scaled RGB565 + palette.
+// Each MCU row is scaled and histogrammed while it's still in internal RAM and
+// only the final pixels are written to PSRAM. JPEGs with restart markers take
+// the dual-core band decode instead and are scaled afterwards
+class ArtPipeline {
+public:
+    // Writes a target x target image into dst, aspect-fit and centred on black
+    static bool run(const uint8_t* jpg, size_t len, uint16_t* dst, int target,
+                    ArtPalette& palette, ArtPipelineStats& stats);
+
+    // Stats from the last successful run
+    static ArtPipelineStats getLastStats();
+};
+
+
+
+#endif //ARTPIPELINE_H
@@ -0,0 +1,224 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "ArtScaler.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+#endif
+
+// Weights are 5 bit (sum 32) so a weighted sum never spills into the next
+// channel: B in bits 0-10, R in 11-20, G in 21-31
+#define SPREAD_MASK 0x07E0F81Fu
+#define WEIGHT_BITS 5
+#define WEIGHT_ONE (1 << WEIGHT_BITS)
+#define SPREAD_ROUND 0x02008010u    // Half a step in each channel
+
+static inline uint32_t spread(uint16_t c) {
+    return (c | ((uint32_t)c << 16)) & SPREAD_MASK;
+}
+
+static inline uint16_t pack(uint32_t s) {
+    return (uint16_t)(s | (s >> 16));
+}
+
+static inline uint32_t normalise(uint32_t acc) {
+    return ((acc + SPREAD_ROUND) >> WEIGHT_BITS) & SPREAD_MASK;
+}
+
+// Scratch touched for every output pixel - has to be internal RAM, plain malloc puts
+// anything over CONFIG_SPIRAM_MALLOC_ALWAYSINTERNAL in PSRAM. Slow beats no art at all
+static void* scratchAlloc(size_t bytes) {
+#ifdef ESP_PLATFORM
+    void* p = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (p) return p;
+#endif
+    return malloc(bytes);
+}
+
+// --- Taps ---
+
+void ArtTapTable::release() {
+    free(first);
+    free(count);
+    free(weights);
+    first = nullptr;
+    count = nullptr;
+    weights = nullptr;
+}
+
+bool ArtTapTable::build(int src, int dst, ArtScaleMode mode) {
+    release();
+    float ratio = (float)src / dst;
+    max_taps = mode == ART_SCALE_AREA ? (int)ceilf(ratio) + 1 : 2;
+    if (max_taps < 2) max_taps = 2;
+
+    first = (int*)malloc(dst * sizeof(int));
+    count = (uint8_t*)malloc(dst);
+    weights = (uint8_t*)calloc(dst * max_taps, 1);
+    if (!first || !count || !weights) return false;
+
+    float w[64];
+    if (max_taps > 64) return false;
+
+    for (int d = 0; d < dst; d++) {
+        int n = 0;
+
+        if (mode == ART_SCALE_AREA) {
+            // Source span covered by this output pixel
+            float lo = d * ratio;
+            float hi = lo + ratio;
+            int s0 = (int)floorf(lo);
+            int s1 = (int)ceilf(hi);
+            if (s1 > src) s1 = src;
+
+            first[d] = s0;
+            for (int s = s0; s < s1 && n < max_taps; s++, n++) {
+                float a = s < lo ? lo : (float)s;
+                float b = s + 1 > hi ? hi : (float)(s + 1);
+                w[n] = (b - a) / ratio;
+            }
+        } else {
+            // Centre-aligned sample point between two neighbours
+            float pos = (d + 0.5f) * ratio - 0.5f;
+            if (pos < 0) pos = 0;
+            int s0 = (int)floorf(pos);
+            if (s0 > src - 1) s0 = src - 1;
+            float frac = pos - s0;
+
+            first[d] = s0;
+            w[n++] = 1.0f - frac;
+            if (s0 + 1 < src) w[n++] = frac;
+            else w[0] = 1.0f;
+        }
+
+        // Quantise on the running total so the weights always sum to exactly 32
+        uint8_t* q = &weights[d * max_taps];
+        float sum = 0;
+        for (int i = 0; i < n; i++) sum += w[i];
+
+        float cumulative = 0;
+        int prev = 0;
+        for (int i = 0; i < n; i++) {
+            cumulative += w[i];
+            int next = i == n - 1 ? WEIGHT_ONE : (int)lroundf(cumulative / sum * WEIGHT_ONE);
+            q[i] = (uint8_t)(next - prev);
+            prev = next;
+        }
+        count[d] = n;
+    }
+    return true;
+}
+
+// One source row -> dw spread pixels
+static void scaleRow(const uint16_t* row, const ArtTapTable& taps, int dw, uint32_t* out) {
+    for (int x = 0; x < dw; x++) {
+        const uint16_t* px = &row[taps.first[x]];
+        const uint8_t* w = &taps.weights[x * taps.max_taps];
+        uint32_t acc = 0;
+
+        for (int i = 0; i < taps.count[x]; i++) {
+            acc += spread(px[i]) * w[i];
+        }
+        out[x] = normalise(acc);
+    }
+}
+
+// --- Stream ---
+
+ArtScaleStream::~ArtScaleStream() {
+    release();
+}
+
+void ArtScaleStream::release() {
+    cols.release();
+    rows.release();
+    free(cache);
+    free(cached_row);
+    free(acc);
+    free(line);
+    cache = nullptr;
+    cached_row = nullptr;
+    acc = nullptr;
+    line = nullptr;
+}
+
+bool ArtScaleStream::begin(int sw, int sh, uint16_t* out, int out_w, int out_h, int out_stride, ArtScaleMode mode) {
+    release();
+    if (!out || sw <= 0 || sh <= 0 || out_w <= 0 || out_h <= 0) return false;
+    if (!cols.build(sw, out_w, mode) || !rows.build(sh, out_h, mode)) return false;
+
+    src_w = sw;
+    dst = out;
+    dw = out_w;
+    dh = out_h;
+    dst_stride = out_stride;
+    next_src = 0;
+    next_dst = 0;
+
+    // Horizontally scaled rows are kept in a ring, neighbouring output rows share their edge row
+    cache = (uint32_t*)scratchAlloc(rows.max_taps * dw * sizeof(uint32_t));
+    cached_row = (int*)scratchAlloc(rows.max_taps * sizeof(int));
+    acc = (uint32_t*)scratchAlloc(dw * sizeof(uint32_t));
+    line = (uint16_t*)scratchAlloc(dw * sizeof(uint16_t));
+    if (!cache || !cached_row || !acc || !line) {
+        release();
+        return false;
+    }
+    for (int i = 0; i < rows.max_taps; i++) cached_row[i] = -1;
+    return true;
+}
+
+void ArtScaleStream::pushRow(const uint16_t* row) {
+    if (!cache || next_src >= rows.first[dh - 1] + rows.count[dh - 1]) {
+        next_src++;
+        return;
+    }
+
+    int sy = next_src++;
+    int slot = sy % rows.max_taps;
+    scaleRow(row, cols, dw, &cache[slot * dw]);
+    cached_row[slot] = sy;
+
+    // Emit every output row whose source rows have all arrived
+    while (next_dst < dh && rows.first[next_dst] + rows.count[next_dst] - 1 <= sy) {
+        emitRow(next_dst++);
+    }
+}
+
+void ArtScaleStream::emitRow(int y) {
+    memset(acc, 0, dw * sizeof(uint32_t));
+    const uint8_t* wy = &rows.weights[y * rows.max_taps];
+
+    for (int i = 0; i < rows.count[y]; i++) {
+        uint32_t weight = wy[i];
+        if (weight == 0) continue;
+
+        const uint32_t* src = &cache[((rows.first[y] + i) % rows.max_taps) * dw];
+        for (int x = 0; x < dw; x++) acc[x] += src[x] * weight;
+    }
+
+    // Finished in the local line first so the callback reads it from there, not the output
+    for (int x = 0; x < dw; x++) line[x] = pack(normalise(acc[x]));
+    if (row_cb) row_cb(line, dw, row_ctx);
+    memcpy(&dst[y * dst_stride], line, dw * sizeof(uint16_t));
+}
+
+// --- One Shot ---
+
+bool ArtScaler::scale(const uint16_t* src, int sw, int sh,
+                      uint16_t* dst, int dw, int dh, int dst_stride,
+                      ArtScaleMode mode) {
+    if (!src) return false;
+
+    ArtScaleStream stream;
+    if (!stream.begin(sw, sh, dst, dw, dh, dst_stride, mode)) return false;
+
+    for (int y = 0; y < sh; y++) stream.pushRow(&src[y * sw]);
+    return stream.isComplete();
+}
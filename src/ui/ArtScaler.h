@@ -0,0 +1,84 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef ARTSCALER_H
+#define ARTSCALER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// No Arduino / LVGL dependencies - builds on the host as-is
+
+enum ArtScaleMode {
+    ART_SCALE_AREA,      // Box filter, exact pixel coverage - for shrinking
+    ART_SCALE_BILINEAR,  // For growing (e.g. the 300px art up to 365)
+};
+
+// Per output pixel along one axis: first source index, tap count and weights (summing to 32)
+struct ArtTapTable {
+    int* first = nullptr;
+    uint8_t* count = nullptr;
+    uint8_t* weights = nullptr;
+    int max_taps = 0;
+
+    ~ArtTapTable() { release(); }
+    bool build(int src, int dst, ArtScaleMode mode);
+    void release();
+};
+
+// Separable RGB565 resampler fed one source row at a time, top to bottom.
+// Pixels are spread into a 32-bit word (G in the top bits, R and B in the low
+// half with guard bits) so all three channels are weighted with one multiply.
+// Only a few scaled rows are held, so the source never has to exist in full
+class ArtScaleStream {
+public:
+    ~ArtScaleStream();
+
+    // Output goes to the top-left out_w x out_h of out
+    bool begin(int sw, int sh, uint16_t* out, int out_w, int out_h, int out_stride, ArtScaleMode mode);
+    void pushRow(const uint16_t* row);
+    bool isComplete() const { return dst && next_dst == dh; }
+
+    // Sees every finished output row before it's written out
+    void setRowCallback(void (*cb)(const uint16_t* row, int width, void* ctx), void* ctx) {
+        row_cb = cb;
+        row_ctx = ctx;
+    }
+
+private:
+    ArtTapTable cols, rows;
+    int src_w = 0;
+    uint16_t* dst = nullptr;
+    int dw = 0, dh = 0, dst_stride = 0;
+    int next_src = 0;
+    int next_dst = 0;
+
+    uint32_t* cache = nullptr;   // rows.max_taps scaled rows
+    int* cached_row = nullptr;
+    uint32_t* acc = nullptr;
+    uint16_t* line = nullptr;
+
+    void (*row_cb)(const uint16_t*, int, void*) = nullptr;
+    void* row_ctx = nullptr;
+
+    void emitRow(int y);
+    void release();
+};
+
+class ArtScaler {
+public:
+    // Scales src (sw x sh, tightly packed) into the top-left dw x dh of dst
+    static bool scale(const uint16_t* src, int sw, int sh,
+                      uint16_t* dst, int dw, int dh, int dst_stride,
+                      ArtScaleMode mode);
+
+    // Area when shrinking, bilinear when growing
+    static ArtScaleMode pickMode(int src_size, int dst_size) {
+        return dst_size < src_size ? ART_SCALE_AREA : ART_SCALE_BILINEAR;
+    }
+};
+
+
+
+#endif //ARTSCALER_H
@@ -0,0 +1,148 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "AssetStore.h"
+
+#include <LittleFS.h>
+
+#include "global_state.h"
+
+#define ASSET_DIR "/assets"
+#define ASSET_MAGIC 0x31415341  // "ASA1"
+
+struct AssetInfo {
+    const char* path;
+    const char* source_url;
+    uint16_t size;
+};
+
+static const AssetInfo ASSETS[ASSET_COUNT] = {
+    { ASSET_DIR "/not_playing_365.bin",
+      "https://raw.githubusercontent.com/Harry-Skerritt/files/refs/heads/main/not_playing_album.jpg",
+      365 },
+};
+
+// On-flash header, pixels follow in lv_color_t order
+struct AssetHeader {
+    uint32_t magic;
+    uint16_t w;
+    uint16_t h;
+};
+
+const lv_img_dsc_t* AssetStore::get(AssetId id) {
+    if (id < 0 || id >= ASSET_COUNT) return nullptr;
+    if (!pixels[id] && !missing[id] && !load(id)) missing[id] = true;
+    return pixels[id] ? &dscs[id] : nullptr;
+}
+
+const char* AssetStore::getSourceUrl(AssetId id) const {
+    return (id >= 0 && id < ASSET_COUNT) ? ASSETS[id].source_url : "";
+}
+
+uint16_t AssetStore::getSize(AssetId id) const {
+    return (id >= 0 && id < ASSET_COUNT) ? ASSETS[id].size : 0;
+}
+
+bool AssetStore::load(AssetId id) {
+    File file = LittleFS.open(ASSETS[id].path, "r");
+    if (!file) return false;
+
+    AssetHeader header;
+    size_t expected = 0;
+    if (file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) && header.magic == ASSET_MAGIC) {
+        expected = (size_t)header.w * header.h * sizeof(lv_color_t);
+    }
+
+    if (expected == 0 || file.size() != sizeof(header) + expected) {
+        Serial.printf("Assets: %s is corrupt, removing\n", ASSETS[id].path);
+        file.close();
+        LittleFS.remove(ASSETS[id].path);
+        return false;
+    }
+
+    uint8_t* data = (uint8_t*)ps_malloc(expected);
+    if (!data) {
+        file.close();
+        return false;
+    }
+
+    uint32_t start = millis();
+    size_t got = file.read(data, expected);
+    file.close();
+
+    if (got != expected) {
+        free(data);
+        return false;
+    }
+
+    adopt(id, data, header.w, header.h);
+    Serial.printf("Assets: Loaded %s in %lums\n", ASSETS[id].path, millis() - start);
+    return true;
+}
+
+bool AssetStore::bake(AssetId id, const lv_color_t* src, uint16_t w, uint16_t h) {
+    if (id < 0 || id >= ASSET_COUNT || !src || pixels[id]) return false;
+
+    // Keep our own copy, the caller's buffer gets reused. Never changes once adopted,
+    // so the system task can write it out without a lock
+    size_t bytes = (size_t)w * h * sizeof(lv_color_t);
+    uint8_t* data = (uint8_t*)ps_malloc(bytes);
+    if (!data) return false;
+    memcpy(data, src, bytes);
+    adopt(id, data, w, h);
+
+    // LittleFS writes take long enough to drop frames
+    write_pending[id].store(true, std::memory_order_release);
+    if (systemTaskHandle != NULL) {
+        xTaskNotify(systemTaskHandle, CMD_ASSET_BAKE, eSetBits);
+    }
+    return true;
+}
+
+void AssetStore::writePending() {
+    for (int id = 0; id < ASSET_COUNT; id++) {
+        if (write_pending[id].exchange(false, std::memory_order_acquire)) write((AssetId)id);
+    }
+}
+
+bool AssetStore::write(AssetId id) {
+    const lv_img_dsc_t& dsc = dscs[id];
+    if (!dsc.data) return false;
+
+    if (!LittleFS.exists(ASSET_DIR)) LittleFS.mkdir(ASSET_DIR);
+
+    // Written to a temp file first so a power cut can't leave half an asset behind
+    String temp = String(ASSETS[id].path) + ".tmp";
+    File file = LittleFS.open(temp, "w");
+    if (!file) return false;
+
+    AssetHeader header = { ASSET_MAGIC, (uint16_t)dsc.header.w, (uint16_t)dsc.header.h };
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              file.write(dsc.data, dsc.data_size) == dsc.data_size;
+    file.close();
+
+    if (!ok || !LittleFS.rename(temp, ASSETS[id].path)) {
+        LittleFS.remove(temp);
+        Serial.printf("Assets: Failed to bake %s\n", ASSETS[id].path);
+        return false;
+    }
+
+    Serial.printf("Assets: Baked %s (%ux%u)\n", ASSETS[id].path, header.w, header.h);
+    return true;
+}
+
+void AssetStore::adopt(AssetId id, uint8_t* data, uint16_t w, uint16_t h) {
+    free(pixels[id]);
+
+    lv_img_dsc_t& dsc = dscs[id];
+    dsc.header.always_zero = 0;
+    dsc.header.cf = LV_IMG_CF_TRUE_COLOR;
+    dsc.header.w = w;
+    dsc.header.h = h;
+    dsc.data_size = (uint32_t)w * h * sizeof(lv_color_t);
+    dsc.data = data;
+
+    pixels[id] = data;
+    missing[id] = false;
+}
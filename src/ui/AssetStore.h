@@ -0,0 +1,59 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef ASSETSTORE_H
+#define ASSETSTORE_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include <atomic>
+
+enum AssetId {
+    ASSET_NONE = -1,
+    ASSET_NOT_PLAYING,
+    ASSET_COUNT
+};
+
+// Static art kept in LittleFS as ready-to-blit RGB565 at display size.
+// Shipped in data/assets (tools/bake_asset.py, then uploadfs). If the file is
+// missing the asset is fetched from its source once, then baked - the pixels
+// are usable straight away, the flash write happens on the system task
+class AssetStore {
+public:
+    static AssetStore& getInstance() {
+        static AssetStore instance;
+        return instance;
+    }
+
+    // nullptr until the asset has been baked
+    const lv_img_dsc_t* get(AssetId id);
+
+    // Graphics task - keeps a copy and queues the write
+    bool bake(AssetId id, const lv_color_t* pixels, uint16_t w, uint16_t h);
+
+    // System task (CMD_ASSET_BAKE) - writes whatever bake() queued
+    void writePending();
+
+    const char* getSourceUrl(AssetId id) const;
+    uint16_t getSize(AssetId id) const;
+
+private:
+    AssetStore() {}
+
+    lv_img_dsc_t dscs[ASSET_COUNT] = {};
+    uint8_t* pixels[ASSET_COUNT] = {};
+    bool missing[ASSET_COUNT] = {};     // Checked flash and it wasn't there
+    std::atomic<bool> write_pending[ASSET_COUNT] = {};
+
+    bool load(AssetId id);
+    bool write(AssetId id);
+    void adopt(AssetId id, uint8_t* data, uint16_t w, uint16_t h);
+
+    AssetStore(const AssetStore&) = delete;
+    void operator=(const AssetStore&) = delete;
+};
+
+
+
+#endif //ASSETSTORE_H
@@ -0,0 +1,426 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "JpegDecoder.h"
+
+#include "tjpgd.h"
+#include "JpegSplit.h"
+#include "system/Telemetry.h"
+
+#define JPEG_WORK_SIZE (12 * 1024)  // TJpgDec at any JD_FASTDECODE level, plus DC tables a cut redefines
+#define JPEG_BAND_STACK 4096
+#define JPEG_CUT_SPLIT_PCT 58       // Top band share without restart markers - it starts before the cut is found
+
+JpegDecodeStats JpegDecoder::last_stats;
+
+// --- Parsing ---
+
+bool JpegDecoder::parse(const uint8_t* jpg, size_t len, JpegInfo& info) {
+    info = JpegInfo();
+    if (!jpg || len < 4 || jpg[0] != 0xFF || jpg[1] != 0xD8) return false;
+
+    size_t pos = 2;
+    while (pos + 4 <= len) {
+        if (jpg[pos] != 0xFF) return false;
+
+        uint8_t marker = jpg[pos + 1];
+        if (marker == 0xFF) {  // Fill byte
+            pos++;
+            continue;
+        }
+
+        size_t seg_len = (jpg[pos + 2] << 8) | jpg[pos + 3];
+        if (pos + 2 + seg_len > len) return false;
+        const uint8_t* seg = &jpg[pos + 4];
+
+        switch (marker) {
+            case 0xC0:
+            case 0xC1:
+                info.baseline = true;
+                [[fallthrough]];
+            case 0xC2:
+                info.sof_pos = pos;
+                info.height = (seg[1] << 8) | seg[2];
+                info.width = (seg[3] << 8) | seg[4];
+                if (seg[5] == 3) {
+                    // Luma sampling decides the MCU size
+                    info.mcu_w = 8 * (seg[7] >> 4);
+                    info.mcu_h = 8 * (seg[7] & 0x0F);
+                }
+                break;
+
+            case 0xDD:
+                info.restart_interval = (seg[0] << 8) | seg[1];
+                break;
+
+            case 0xDA:
+                info.scan_pos = pos + 2 + seg_len;
+                return info.sof_pos != 0 && info.width > 0 && info.height > 0;
+
+            default:
+                break;
+        }
+
+        pos += 2 + seg_len;
+    }
+
+    return false;
+}
+
+// Offset of the nth (0 based) restart marker and the EOI, skipping stuffed bytes
+static bool findMarkers(const uint8_t* jpg, size_t len, size_t start, uint32_t nth, size_t& rst_pos, size_t& eoi_pos) {
+    uint32_t seen = 0;
+    rst_pos = 0;
+
+    for (size_t i = start; i + 1 < len; i++) {
+        if (jpg[i] != 0xFF) continue;
+
+        uint8_t next = jpg[i + 1];
+        if (next >= 0xD0 && next <= 0xD7) {
+            if (seen++ == nth) rst_pos = i;
+            i++;
+        } else if (next == 0xD9) {
+            eoi_pos = i;
+            return rst_pos != 0;
+        } else if (next == 0x00) {
+            i++;
+        }
+    }
+    return false;
+}
+
+// --- Decoding ---
+
+struct BandJob {
+    const uint8_t* data = nullptr;  // A complete JPEG for just this band
+    size_t len = 0;
+    size_t read_pos = 0;
+
+    // Non zero: the SOF height is swapped for this as the headers are read
+    uint16_t patch_height = 0;
+    size_t sof_pos = 0;
+
+    uint16_t* out = nullptr;
+    uint16_t stride = 0;
+    uint16_t row_offset = 0;
+
+    // Strip mode
+    uint16_t* strip = nullptr;
+    uint16_t strip_top = 0;
+    JpegStripCallback strip_cb = nullptr;
+    void* strip_ctx = nullptr;
+
+    bool ok = false;
+    uint32_t us = 0;
+    SemaphoreHandle_t done = nullptr;
+};
+
+static size_t bandInput(JDEC* jd, uint8_t* buf, size_t n) {
+    BandJob* job = (BandJob*)jd->device;
+    size_t left = job->len - job->read_pos;
+    if (n > left) n = left;
+    if (buf) {
+        memcpy(buf, &job->data[job->read_pos], n);
+
+        // Top band of a cut - TJpgDec stops once it has this many rows
+        for (int i = 0; i < 2 && job->patch_height; i++) {
+            size_t at = job->sof_pos + 5 + i;
+            if (at >= job->read_pos && at < job->read_pos + n) {
+                buf[at - job->read_pos] = i ? job->patch_height & 0xFF : job->patch_height >> 8;
+            }
+        }
+    }
+    job->read_pos += n;
+    return n;
+}
+
+static int bandOutput(JDEC* jd, void* bitmap, JRECT* rect) {
+    BandJob* job = (BandJob*)jd->device;
+    uint16_t w = rect->right - rect->left + 1;
+
+#if JD_FORMAT == 1
+    const uint16_t* src = (const uint16_t*)bitmap;
+    for (uint16_t y = rect->top; y <= rect->bottom; y++) {
+        memcpy(&job->out[(job->row_offset + y) * job->stride + rect->left], src, w * sizeof(uint16_t));
+        src += w;
+    }
+#else
+    // RGB888 build of TJpgDec
+    const uint8_t* src = (const uint8_t*)bitmap;
+    for (uint16_t y = rect->top; y <= rect->bottom; y++) {
+        uint16_t* dst = &job->out[(job->row_offset + y) * job->stride + rect->left];
+        for (uint16_t x = 0; x < w; x++, src += 3) {
+            dst[x] = ((src[0] & 0xF8) << 8) | ((src[1] & 0xFC) << 3) | (src[2] >> 3);
+        }
+    }
+#endif
+    return 1;
+}
+
+// Collects MCUs into the strip, handing it on when the last one in the row lands
+static int stripOutput(JDEC* jd, void* bitmap, JRECT* rect) {
+    BandJob* job = (BandJob*)jd->device;
+    uint16_t w = rect->right - rect->left + 1;
+
+#if JD_FORMAT == 1
+    const uint16_t* src = (const uint16_t*)bitmap;
+    for (uint16_t y = rect->top; y <= rect->bottom; y++) {
+        memcpy(&job->strip[(y - job->strip_top) * job->stride + rect->left], src, w * sizeof(uint16_t));
+        src += w;
+    }
+#else
+    const uint8_t* src = (const uint8_t*)bitmap;
+    for (uint16_t y = rect->top; y <= rect->bottom; y++) {
+        uint16_t* dst = &job->strip[(y - job->strip_top) * job->stride + rect->left];
+        for (uint16_t x = 0; x < w; x++, src += 3) {
+            dst[x] = ((src[0] & 0xF8) << 8) | ((src[1] & 0xFC) << 3) | (src[2] >> 3);
+        }
+    }
+#endif
+
+    if (rect->right + 1 >= job->stride) {
+        uint16_t rows = rect->bottom - job->strip_top + 1;
+        job->strip_cb(job->strip, job->strip_top, rows, job->stride, job->strip_ctx);
+        job->strip_top = rect->bottom + 1;
+    }
+    return 1;
+}
+
+static void runBand(BandJob& job, int (*outfunc)(JDEC*, void*, JRECT*) = bandOutput) {
+    uint32_t start = micros();
+    job.ok = false;
+    job.read_pos = 0;
+
+    void* work = heap_caps_malloc(JPEG_WORK_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!work) work = ps_malloc(JPEG_WORK_SIZE);
+
+    if (work) {
+        JDEC jd;
+        if (jd_prepare(&jd, bandInput, work, JPEG_WORK_SIZE, &job) == JDR_OK) {
+            job.ok = jd_decomp(&jd, outfunc, 0) == JDR_OK;
+        }
+        free(work);
+    }
+
+    job.us = micros() - start;
+}
+
+static void bandTask(void* pvParameters) {
+    BandJob* job = (BandJob*)pvParameters;
+    runBand(*job);
+    xSemaphoreGive(job->done);
+    Telemetry::getInstance().taskFinished();
+    vTaskDelete(NULL);
+}
+
+// Copies the headers with a new image height, then the entropy slice with its
+// restart markers renumbered from RST0 and a closing EOI
+static uint8_t* buildBand(const uint8_t* jpg, const JpegInfo& info, uint16_t height,
+                          size_t from, size_t to, uint8_t rst_shift, size_t& out_len) {
+    size_t slice = to - from;
+    out_len = info.scan_pos + slice + 2;
+
+    uint8_t* band = (uint8_t*)ps_malloc(out_len);
+    if (!band) return nullptr;
+
+    memcpy(band, jpg, info.scan_pos);
+    band[info.sof_pos + 5] = height >> 8;
+    band[info.sof_pos + 6] = height & 0xFF;
+
+    uint8_t* data = &band[info.scan_pos];
+    memcpy(data, &jpg[from], slice);
+
+    for (size_t i = 0; i + 1 < slice; i++) {
+        if (data[i] != 0xFF) continue;
+        uint8_t next = data[i + 1];
+        if (next >= 0xD0 && next <= 0xD7) {
+            data[i + 1] = 0xD0 + ((next - 0xD0 - rst_shift) & 7);
+            i++;
+        } else if (next == 0x00) {
+            i++;
+        }
+    }
+
+    band[out_len - 2] = 0xFF;
+    band[out_len - 1] = 0xD9;
+    return band;
+}
+
+bool JpegDecoder::decode(const uint8_t* jpg, size_t len, uint16_t* out, bool allow_parallel) {
+    uint32_t start = micros();
+    last_stats = JpegDecodeStats();
+
+    JpegInfo info;
+    if (!out || !parse(jpg, len, info) || !info.baseline) return false;
+
+    // Split on the restart marker closest to the middle MCU row
+    uint16_t mcus_per_row = (info.width + info.mcu_w - 1) / info.mcu_w;
+    uint16_t mcu_rows = (info.height + info.mcu_h - 1) / info.mcu_h;
+    uint16_t split_row = 0;
+
+    if (allow_parallel && info.restart_interval > 0 && mcu_rows >= 2) {
+        for (uint16_t d = 0; d < mcu_rows / 2 && !split_row; d++) {
+            for (int dir = -1; dir <= 1; dir += 2) {
+                int row = mcu_rows / 2 + dir * d;
+                if (row > 0 && row < mcu_rows && ((uint32_t)row * mcus_per_row) % info.restart_interval == 0) {
+                    split_row = row;
+                    break;
+                }
+            }
+        }
+    }
+
+    size_t rst_pos = 0, eoi_pos = len;
+    uint32_t marker_index = 0;
+    if (split_row) {
+        marker_index = (uint32_t)split_row * mcus_per_row / info.restart_interval - 1;
+        if (!findMarkers(jpg, len, info.scan_pos, marker_index, rst_pos, eoi_pos)) split_row = 0;
+    }
+
+    if (!split_row) {
+        if (allow_parallel && info.restart_interval == 0 && decodeCut(jpg, len, info, out, start)) return true;
+
+        BandJob job;
+        job.data = jpg;
+        job.len = len;
+        job.out = out;
+        job.stride = info.width;
+        runBand(job);
+
+        last_stats.bands = 1;
+        last_stats.band_us[0] = job.us;
+        last_stats.total_us = micros() - start;
+        return job.ok;
+    }
+
+    uint16_t top_height = split_row * info.mcu_h;
+    BandJob top, bottom;
+
+    top.data = buildBand(jpg, info, top_height, info.scan_pos, rst_pos, 0, top.len);
+    bottom.data = buildBand(jpg, info, info.height - top_height, rst_pos + 2, eoi_pos,
+                            (marker_index + 1) & 7, bottom.len);
+    bottom.done = xSemaphoreCreateBinary();
+
+    bool ok = false;
+    if (top.data && bottom.data && bottom.done) {
+        top.out = bottom.out = out;
+        top.stride = bottom.stride = info.width;
+        bottom.row_offset = top_height;
+
+        // Lower band on core 0, top band here
+        if (xTaskCreatePinnedToCore(bandTask, "JpegBand", JPEG_BAND_STACK, &bottom, 2, NULL, 0) == pdPASS) {
+            runBand(top);
+            xSemaphoreTake(bottom.done, portMAX_DELAY);
+        } else {
+            runBand(top);
+            runBand(bottom);
+        }
+        ok = top.ok && bottom.ok;
+    }
+
+    free((void*)top.data);
+    free((void*)bottom.data);
+    if (bottom.done) vSemaphoreDelete(bottom.done);
+
+    last_stats.bands = 2;
+    last_stats.band_us[0] = top.us;
+    last_stats.band_us[1] = bottom.us;
+    last_stats.total_us = micros() - start;
+
+    // A band that didn't decode falls back to doing the whole image in one go
+    if (!ok) return decode(jpg, len, out, false);
+    return true;
+}
+
+bool JpegDecoder::decodeCut(const uint8_t* jpg, size_t len, const JpegInfo& info, uint16_t* out, uint32_t start) {
+    uint16_t mcu_rows = (info.height + info.mcu_h - 1) / info.mcu_h;
+    uint16_t split_row = (uint32_t)mcu_rows * JPEG_CUT_SPLIT_PCT / 100;
+    if (split_row == 0 || split_row >= mcu_rows || !JpegSplit::supported(jpg, len)) return false;
+
+    uint16_t top_height = split_row * info.mcu_h;
+    BandJob top, bottom;
+
+    // The top band is just the original read with a shorter height, so it can start right away
+    top.data = jpg;
+    top.len = len;
+    top.patch_height = top_height;
+    top.sof_pos = info.sof_pos;
+    top.out = bottom.out = out;
+    top.stride = bottom.stride = info.width;
+    bottom.row_offset = top_height;
+
+    top.done = xSemaphoreCreateBinary();
+    if (!top.done) return false;
+    if (xTaskCreatePinnedToCore(bandTask, "JpegBand", JPEG_BAND_STACK, &top, 2, NULL, 0) != pdPASS) {
+        vSemaphoreDelete(top.done);
+        return false;
+    }
+
+    uint32_t cut_start = micros();
+    bottom.data = JpegSplit::lowerBand(jpg, len, split_row, bottom.len);
+    uint32_t cut_us = micros() - cut_start;
+    if (bottom.data) runBand(bottom);
+
+    xSemaphoreTake(top.done, portMAX_DELAY);
+    vSemaphoreDelete(top.done);
+    free((void*)bottom.data);
+
+    last_stats.bands = 2;
+    last_stats.band_us[0] = top.us;
+    last_stats.band_us[1] = bottom.us;
+    last_stats.cut_us = cut_us;
+    last_stats.total_us = micros() - start;
+
+    // Anything short of both bands is decoded again on one core by the caller
+    return top.ok && bottom.data && bottom.ok;
+}
+
+bool JpegDecoder::decodeStrips(const uint8_t* jpg, size_t len, JpegStripCallback cb, void* ctx) {
+    uint32_t start = micros();
+    last_stats = JpegDecodeStats();
+
+    JpegInfo info;
+    if (!cb || !parse(jpg, len, info) || !info.baseline) return false;
+
+    BandJob job;
+    job.data = jpg;
+    job.len = len;
+    job.stride = info.width;
+    job.strip_cb = cb;
+    job.strip_ctx = ctx;
+
+    // One MCU row - small enough to stay in internal RAM
+    size_t strip_size = (size_t)info.width * info.mcu_h * sizeof(uint16_t);
+    job.strip = (uint16_t*)heap_caps_malloc(strip_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!job.strip) job.strip = (uint16_t*)ps_malloc(strip_size);
+    if (!job.strip) return false;
+
+    runBand(job, stripOutput);
+    free(job.strip);
+
+    last_stats.bands = 1;
+    last_stats.band_us[0] = job.us;
+    last_stats.total_us = micros() - start;
+    return job.ok;
+}
+
+#ifdef JPEG_DECODE_BENCHMARK
+void JpegDecoder::benchmark(const uint8_t* jpg, size_t len) {
+    JpegInfo info;
+    if (!parse(jpg, len, info)) return;
+
+    uint16_t* out = (uint16_t*)ps_malloc((size_t)info.width * info.height * sizeof(uint16_t));
+    if (!out) return;
+
+    decode(jpg, len, out, false);
+    uint32_t single_us = last_stats.total_us;
+
+    decode(jpg, len, out, true);
+    Serial.printf("Bench: %ux%u JPEG (RST every %u MCUs) single %uus, dual %uus over %u bands (%u / %u, cut %u)\n",
+        info.width, info.height, info.restart_interval, single_us, last_stats.total_us,
+        last_stats.bands, last_stats.band_us[0], last_stats.band_us[1], last_stats.cut_us);
+
+    free(out);
+}
+#endif
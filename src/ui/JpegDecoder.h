@@ -0,0 +1,62 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef JPEGDECODER_H
+#define JPEGDECODER_H
+
+#include <Arduino.h>
+
+struct JpegInfo {
+    uint16_t width = 0;
+    uint16_t height = 0;
+    uint8_t mcu_w = 8;
+    uint8_t mcu_h = 8;
+    uint16_t restart_interval = 0;  // MCUs between RST markers, 0 if none
+    size_t sof_pos = 0;             // Offset of the SOF marker
+    size_t scan_pos = 0;            // First byte of entropy-coded data
+    bool baseline = false;
+};
+
+struct JpegDecodeStats {
+    uint32_t total_us = 0;
+    uint32_t band_us[2] = {};
+    uint32_t cut_us = 0;            // Scanning for a split without restart markers
+    uint8_t bands = 0;
+};
+
+// Called once per finished MCU row, strip holds rows x width pixels in internal RAM
+typedef void (*JpegStripCallback)(const uint16_t* strip, uint16_t y, uint16_t rows, uint16_t width, void* ctx);
+
+// Baseline JPEG -> RGB565 through TJpgDec, split into two bands across both cores.
+// With restart markers on an MCU row boundary near the middle each band is
+// re-wrapped as its own JPEG and the lower band decodes on core 0 while the
+// calling task does the top one. Without them (most Spotify art) the top band
+// starts on core 0 straight away while the calling task cuts the lower band out
+// with JpegSplit and then decodes it
+class JpegDecoder {
+public:
+    static bool parse(const uint8_t* jpg, size_t len, JpegInfo& info);
+
+    // out must hold width * height pixels
+    static bool decode(const uint8_t* jpg, size_t len, uint16_t* out, bool allow_parallel = true);
+
+    // Single core, hands over one MCU row at a time so the full image never has to exist
+    static bool decodeStrips(const uint8_t* jpg, size_t len, JpegStripCallback cb, void* ctx);
+
+    static const JpegDecodeStats& getLastStats() { return last_stats; }
+
+#ifdef JPEG_DECODE_BENCHMARK
+    // Decodes the same image single and dual core and prints both
+    static void benchmark(const uint8_t* jpg, size_t len);
+#endif
+
+private:
+    static JpegDecodeStats last_stats;
+
+    static bool decodeCut(const uint8_t* jpg, size_t len, const JpegInfo& info, uint16_t* out, uint32_t start);
+};
+
+
+
+#endif //JPEGDECODER_H
@@ -0,0 +1,584 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "JpegSplit.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+#endif
+
+#define HUFF_LUT_BITS 9         // Codes up to this long decode with one lookup
+#define DC_MAX_CATEGORY 11      // 8 bit samples never need more
+
+struct HuffTable {
+    bool defined;
+    uint8_t bits[17];           // Codes of each length, 1 based
+    uint8_t vals[256];
+    uint16_t count;
+    uint8_t max_len;
+    bool spare;                 // Code space left at max_len
+    int32_t maxcode[17];
+    int32_t mincode[17];
+    uint16_t valptr[17];
+    uint16_t lut[1 << HUFF_LUT_BITS];   // (length << 8) | symbol, 0 when the code is longer
+    uint16_t dc_code[16];       // DC categories, for re-encoding
+    uint8_t dc_len[16];
+};
+
+struct ScanComponent {
+    uint8_t blocks;             // Per MCU
+    uint8_t dc;
+    uint8_t ac;
+};
+
+struct JpegLayout {
+    HuffTable tables[4];        // DC0, DC1, AC0, AC1
+    ScanComponent comps[3];     // Scan order
+    uint16_t width;
+    uint16_t height;
+    uint8_t mcu_w;
+    uint8_t mcu_h;
+    size_t sof_pos;
+    size_t sos_pos;
+    size_t scan_pos;
+};
+
+// Tables are hit for every symbol - internal RAM like the scaler's scratch
+static void* scratchAlloc(size_t bytes) {
+#ifdef ESP_PLATFORM
+    void* p = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (p) return p;
+#endif
+    return malloc(bytes);
+}
+
+// --- Bits ---
+
+// Entropy data with the stuffed zero bytes removed. Stops at the first marker,
+// bits goes negative if a decode runs past it
+struct BitReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    uint32_t acc;
+    int bits;
+    bool at_marker;
+
+    void begin(const uint8_t* from, const uint8_t* to) {
+        p = from;
+        end = to;
+        acc = 0;
+        bits = 0;
+        at_marker = false;
+    }
+
+    inline void fill() {
+        while (bits <= 24 && !at_marker) {
+            if (p >= end) {
+                at_marker = true;
+                break;
+            }
+            uint8_t b = *p;
+            if (b == 0xFF) {
+                if (p + 1 >= end || p[1] != 0x00) {
+                    at_marker = true;
+                    break;
+                }
+                p += 2;
+            } else {
+                p++;
+            }
+            acc |= (uint32_t)b << (24 - bits);
+            bits += 8;
+        }
+    }
+
+    // 1 - 16 bits
+    inline uint32_t peek(int n) const { return acc >> (32 - n); }
+
+    inline void skip(int n) {
+        acc <<= n;
+        bits -= n;
+    }
+};
+
+struct BitWriter {
+    uint8_t* p;
+    uint8_t* end;
+    uint32_t acc;
+    int bits;
+    bool overflow;
+
+    void begin(uint8_t* from, uint8_t* to) {
+        p = from;
+        end = to;
+        acc = 0;
+        bits = 0;
+        overflow = false;
+    }
+
+    inline void emit(uint8_t b) {
+        if (p < end) *p++ = b;
+        else overflow = true;
+    }
+
+    // Up to 16 bits
+    inline void put(uint32_t v, int n) {
+        acc = (acc << n) | (v & ((1u << n) - 1));
+        bits += n;
+        while (bits >= 8) {
+            bits -= 8;
+            uint8_t b = acc >> bits;
+            emit(b);
+            if (b == 0xFF) emit(0x00);
+        }
+    }
+
+    // Pads the last byte with 1s
+    void flush() {
+        if (bits) put(0xFF, 8 - bits);
+    }
+};
+
+// --- Huffman ---
+
+static bool buildTable(HuffTable& t) {
+    memset(t.lut, 0, sizeof(t.lut));
+    memset(t.dc_len, 0, sizeof(t.dc_len));
+    t.max_len = 0;
+    t.spare = false;
+
+    uint32_t code = 0;
+    uint16_t k = 0;
+    for (int l = 1; l <= 16; l++) {
+        t.valptr[l] = k;
+        t.mincode[l] = code;
+
+        for (int i = 0; i < t.bits[l]; i++, k++, code++) {
+            uint8_t sym = t.vals[k];
+            if (l <= HUFF_LUT_BITS) {
+                uint32_t first = code << (HUFF_LUT_BITS - l);
+                uint32_t n = 1u << (HUFF_LUT_BITS - l);
+                for (uint32_t j = 0; j < n; j++) t.lut[first + j] = (l << 8) | sym;
+            }
+            if (sym < 16) {
+                t.dc_code[sym] = code;
+                t.dc_len[sym] = l;
+            }
+        }
+
+        if (code > (1u << l)) return false;  // More codes than fit
+        t.maxcode[l] = t.bits[l] ? (int32_t)code - 1 : -1;
+        if (t.bits[l]) {
+            t.max_len = l;
+            t.spare = code < (1u << l);
+        }
+        code <<= 1;
+    }
+    return true;
+}
+
+// Adds the missing categories on codes longer than any the table has, one
+// length each, so the canonical codes already in use don't move
+static bool growTable(HuffTable& t, uint16_t categories, bool& grown) {
+    uint8_t len = t.max_len;
+    for (int c = 0; c < 16; c++) {
+        if (!(categories & (1 << c)) || t.dc_len[c]) continue;
+        if (++len > 16 || t.count >= 256) return false;
+        t.bits[len]++;
+        t.vals[t.count++] = c;
+        grown = true;
+    }
+    return !grown || buildTable(t);
+}
+
+static inline int decodeSymbol(BitReader& br, const HuffTable& t) {
+    br.fill();
+    uint16_t e = t.lut[br.peek(HUFF_LUT_BITS)];
+    if (e) {
+        br.skip(e >> 8);
+        return e & 0xFF;
+    }
+
+    for (int l = HUFF_LUT_BITS + 1; l <= 16; l++) {
+        int32_t c = br.peek(l);
+        if (c <= t.maxcode[l]) {
+            br.skip(l);
+            return t.vals[t.valptr[l] + c - t.mincode[l]];
+        }
+    }
+    return -1;
+}
+
+static inline int32_t receive(BitReader& br, int s) {
+    if (!s) return 0;
+    br.fill();
+    int32_t v = br.peek(s);
+    br.skip(s);
+    return v < (1 << (s - 1)) ? v - ((1 << s) - 1) : v;
+}
+
+static int category(int32_t v) {
+    uint32_t a = v < 0 ? -v : v;
+    int s = 0;
+    for (; a; a >>= 1) s++;
+    return s;
+}
+
+// Decodes a symbol and writes its code back out unchanged
+static inline int copySymbol(BitReader& br, const HuffTable& t, BitWriter& bw) {
+    br.fill();
+    int before = br.bits;
+    uint32_t ahead = br.peek(16);
+
+    int sym = decodeSymbol(br, t);
+    if (sym >= 0) {
+        int n = before - br.bits;
+        bw.put(ahead >> (16 - n), n);
+    }
+    return sym;
+}
+
+static inline void copyBits(BitReader& br, BitWriter& bw, int n) {
+    if (!n) return;
+    br.fill();
+    bw.put(br.peek(n), n);
+    br.skip(n);
+}
+
+// Walks one block, diff is its DC difference
+static bool skipBlock(BitReader& br, const HuffTable& dc, const HuffTable& ac, int32_t& diff) {
+    int s = decodeSymbol(br, dc);
+    if (s < 0 || s > 15) return false;
+    diff = receive(br, s);
+
+    int k = 1;
+    while (k < 64) {
+        int rs = decodeSymbol(br, ac);
+        if (rs < 0) return false;
+
+        int r = rs >> 4;
+        s = rs & 0x0F;
+        if (!s) {
+            if (r != 15) break;  // EOB
+            k += 16;
+            continue;
+        }
+
+        k += r;
+        if (k > 63) return false;
+        br.fill();
+        br.skip(s);
+        k++;
+    }
+    return k <= 64 && br.bits >= 0;
+}
+
+// Copies one block, with an absolute DC in place of the difference when dc_value is set
+static bool copyBlock(BitReader& br, BitWriter& bw, const HuffTable& dc, const HuffTable& ac, const int32_t* dc_value) {
+    if (dc_value) {
+        int s = decodeSymbol(br, dc);
+        if (s < 0 || s > 15) return false;
+        receive(br, s);
+
+        int cat = category(*dc_value);
+        if (cat > 15 || !dc.dc_len[cat]) return false;
+        bw.put(dc.dc_code[cat], dc.dc_len[cat]);
+        if (cat) bw.put(*dc_value < 0 ? *dc_value - 1 : *dc_value, cat);
+    } else {
+        int s = copySymbol(br, dc, bw);
+        if (s < 0 || s > 15) return false;
+        copyBits(br, bw, s);
+    }
+
+    int k = 1;
+    while (k < 64) {
+        int rs = copySymbol(br, ac, bw);
+        if (rs < 0) return false;
+
+        int r = rs >> 4;
+        int s = rs & 0x0F;
+        if (!s) {
+            if (r != 15) break;
+            k += 16;
+            continue;
+        }
+
+        k += r;
+        if (k > 63) return false;
+        copyBits(br, bw, s);
+        k++;
+    }
+    return k <= 64 && br.bits >= 0;
+}
+
+// --- Headers ---
+
+static bool parseTables(const uint8_t* seg, size_t n, JpegLayout& lay) {
+    while (n >= 17) {
+        uint8_t tc = seg[0] >> 4;
+        uint8_t th = seg[0] & 0x0F;
+        if (tc > 1 || th > 1) return false;  // Baseline only has two of each
+
+        HuffTable& t = lay.tables[tc * 2 + th];
+        uint16_t count = 0;
+        t.bits[0] = 0;
+        for (int l = 1; l <= 16; l++) {
+            t.bits[l] = seg[l];
+            count += seg[l];
+        }
+        if (count > 256 || n < 17u + count) return false;
+
+        memcpy(t.vals, &seg[17], count);
+        t.count = count;
+        if (!buildTable(t)) return false;
+        t.defined = true;
+
+        seg += 17 + count;
+        n -= 17 + count;
+    }
+    return n == 0;
+}
+
+static bool parseLayout(const uint8_t* jpg, size_t len, JpegLayout& lay) {
+    memset(&lay, 0, sizeof(lay));
+    if (!jpg || len < 4 || jpg[0] != 0xFF || jpg[1] != 0xD8) return false;
+
+    uint8_t frame_id[3] = {};
+    uint8_t frame_hv[3] = {};
+    bool have_frame = false;
+
+    size_t pos = 2;
+    while (pos + 4 <= len) {
+        if (jpg[pos] != 0xFF) return false;
+
+        uint8_t marker = jpg[pos + 1];
+        if (marker == 0xFF) {  // Fill byte
+            pos++;
+            continue;
+        }
+
+        size_t seg_len = (jpg[pos + 2] << 8) | jpg[pos + 3];
+        if (seg_len < 2 || pos + 2 + seg_len > len) return false;
+        const uint8_t* seg = &jpg[pos + 4];
+        size_t n = seg_len - 2;
+
+        switch (marker) {
+            case 0xC0:
+            case 0xC1:
+                if (n < 15 || seg[0] != 8 || seg[5] != 3) return false;
+                lay.sof_pos = pos;
+                lay.height = (seg[1] << 8) | seg[2];
+                lay.width = (seg[3] << 8) | seg[4];
+                for (int i = 0; i < 3; i++) {
+                    frame_id[i] = seg[6 + i * 3];
+                    frame_hv[i] = seg[7 + i * 3];
+                }
+                have_frame = true;
+                break;
+
+            case 0xC4:
+                if (!parseTables(seg, n, lay)) return false;
+                break;
+
+            case 0xDD:
+                if (n < 2 || seg[0] || seg[1]) return false;  // Restart markers split the easy way
+                break;
+
+            case 0xDA:
+                if (!have_frame || n < 10 || seg[0] != 3) return false;
+                for (int i = 0; i < 3; i++) {
+                    int f = 0;
+                    while (f < 3 && frame_id[f] != seg[1 + i * 2]) f++;
+                    if (f == 3) return false;
+
+                    uint8_t h = frame_hv[f] >> 4;
+                    uint8_t v = frame_hv[f] & 0x0F;
+                    if (f == 0) {
+                        // Luma decides the MCU, chroma has to be one block like TJpgDec wants
+                        if (h < 1 || h > 2 || v < 1 || v > 2) return false;
+                        lay.mcu_w = 8 * h;
+                        lay.mcu_h = 8 * v;
+                    } else if (frame_hv[f] != 0x11) {
+                        return false;
+                    }
+
+                    ScanComponent& c = lay.comps[i];
+                    c.blocks = h * v;
+                    c.dc = seg[2 + i * 2] >> 4;
+                    c.ac = seg[2 + i * 2] & 0x0F;
+                    if (c.dc > 1 || c.ac > 1 || !lay.tables[c.dc].defined || !lay.tables[2 + c.ac].defined) return false;
+                }
+                lay.sos_pos = pos;
+                lay.scan_pos = pos + 2 + seg_len;
+                return lay.width > 0 && lay.height > 0;
+
+            default:
+                // Progressive, lossless and arithmetic coded frames
+                if (marker >= 0xC2 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) return false;
+                break;
+        }
+
+        pos += 2 + seg_len;
+    }
+    return false;
+}
+
+static JpegLayout* loadLayout(const uint8_t* jpg, size_t len) {
+    JpegLayout* lay = (JpegLayout*)scratchAlloc(sizeof(JpegLayout));
+    if (lay && !parseLayout(jpg, len, *lay)) {
+        free(lay);
+        lay = nullptr;
+    }
+    return lay;
+}
+
+// --- Split ---
+
+bool JpegSplit::supported(const uint8_t* jpg, size_t len) {
+    JpegLayout* lay = loadLayout(jpg, len);
+    if (!lay) return false;
+
+    bool ok = true;
+    for (int t = 0; t < 2; t++) {
+        int users = 0;
+        for (int i = 0; i < 3; i++) users += lay->comps[i].dc == t;
+        if (!users) continue;
+
+        // Either every category is already there or there's room to add what the cut needs
+        const HuffTable& dc = lay->tables[t];
+        bool complete = true;
+        for (int c = 0; c <= DC_MAX_CATEGORY; c++) complete = complete && dc.dc_len[c];
+        if (!complete && (!dc.spare || dc.max_len + users > 16)) ok = false;
+    }
+
+    free(lay);
+    return ok;
+}
+
+static uint8_t* cut(const uint8_t* jpg, size_t len, JpegLayout& lay, uint16_t from_row, size_t& out_len) {
+    uint16_t mcus_per_row = (lay.width + lay.mcu_w - 1) / lay.mcu_w;
+    uint16_t mcu_rows = (lay.height + lay.mcu_h - 1) / lay.mcu_h;
+    if (from_row == 0 || from_row >= mcu_rows) return nullptr;
+
+    // Walk everything above the cut for the DC predictors
+    BitReader br;
+    br.begin(&jpg[lay.scan_pos], &jpg[len]);
+    int32_t pred[3] = {};
+
+    uint32_t skip = (uint32_t)from_row * mcus_per_row;
+    for (uint32_t m = 0; m < skip; m++) {
+        for (int i = 0; i < 3; i++) {
+            const ScanComponent& c = lay.comps[i];
+            for (int b = 0; b < c.blocks; b++) {
+                int32_t diff;
+                if (!skipBlock(br, lay.tables[c.dc], lay.tables[2 + c.ac], diff)) return nullptr;
+                pred[i] += diff;
+            }
+        }
+    }
+
+    // The first block of each component in the new band has nothing to predict from
+    BitReader first_mcu = br;
+    int32_t first_dc[3];
+    uint16_t needed[2] = {};
+    for (int i = 0; i < 3; i++) {
+        const ScanComponent& c = lay.comps[i];
+        for (int b = 0; b < c.blocks; b++) {
+            int32_t diff;
+            if (!skipBlock(br, lay.tables[c.dc], lay.tables[2 + c.ac], diff)) return nullptr;
+            if (b == 0) first_dc[i] = pred[i] + diff;
+        }
+        int cat = category(first_dc[i]);
+        if (cat > 15) return nullptr;
+        needed[c.dc] |= 1 << cat;
+    }
+    br = first_mcu;
+
+    bool grown[2] = {};
+    for (int t = 0; t < 2; t++) {
+        if (needed[t] && !growTable(lay.tables[t], needed[t], grown[t])) return nullptr;
+    }
+
+    // Grown tables go in a DHT of their own just before the scan, the later definition wins
+    size_t dht_len = 0;
+    for (int t = 0; t < 2; t++) {
+        if (grown[t]) dht_len += 17 + lay.tables[t].count;
+    }
+    if (dht_len) dht_len += 4;
+
+    size_t sos_len = lay.scan_pos - lay.sos_pos;
+    size_t entropy = len - lay.scan_pos;
+    size_t cap = lay.sos_pos + dht_len + sos_len + entropy + entropy / 16 + 64;
+
+    uint8_t* band = (uint8_t*)malloc(cap);
+    if (!band) return nullptr;
+
+    uint16_t height = lay.height - from_row * lay.mcu_h;
+    memcpy(band, jpg, lay.sos_pos);
+    band[lay.sof_pos + 5] = height >> 8;
+    band[lay.sof_pos + 6] = height & 0xFF;
+
+    uint8_t* p = &band[lay.sos_pos];
+    if (dht_len) {
+        *p++ = 0xFF;
+        *p++ = 0xC4;
+        *p++ = (dht_len - 2) >> 8;
+        *p++ = (dht_len - 2) & 0xFF;
+        for (int t = 0; t < 2; t++) {
+            if (!grown[t]) continue;
+            const HuffTable& dc = lay.tables[t];
+            *p++ = t;
+            memcpy(p, &dc.bits[1], 16);
+            p += 16;
+            memcpy(p, dc.vals, dc.count);
+            p += dc.count;
+        }
+    }
+    memcpy(p, &jpg[lay.sos_pos], sos_len);
+    p += sos_len;
+
+    BitWriter bw;
+    bw.begin(p, &band[cap - 2]);
+
+    bool ok = true;
+    for (int i = 0; i < 3 && ok; i++) {
+        const ScanComponent& c = lay.comps[i];
+        for (int b = 0; b < c.blocks && ok; b++) {
+            ok = copyBlock(br, bw, lay.tables[c.dc], lay.tables[2 + c.ac], b == 0 ? &first_dc[i] : nullptr);
+        }
+    }
+
+    // Everything after the first MCU is unchanged, just moved to a new bit offset
+    while (ok) {
+        br.fill();
+        if (br.bits <= 0) break;
+        int n = br.bits < 16 ? br.bits : 16;
+        bw.put(br.peek(n), n);
+        br.skip(n);
+    }
+    bw.flush();
+
+    if (!ok || bw.overflow) {
+        free(band);
+        return nullptr;
+    }
+
+    *bw.p++ = 0xFF;
+    *bw.p++ = 0xD9;
+    out_len = bw.p - band;
+    return band;
+}
+
+uint8_t* JpegSplit::lowerBand(const uint8_t* jpg, size_t len, uint16_t from_row, size_t& out_len) {
+    out_len = 0;
+    JpegLayout* lay = loadLayout(jpg, len);
+    if (!lay) return nullptr;
+
+    uint8_t* band = cut(jpg, len, *lay, from_row, out_len);
+    free(lay);
+    return band;
+}
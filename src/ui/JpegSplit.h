@@ -0,0 +1,32 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef JPEGSPLIT_H
+#define JPEGSPLIT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// No Arduino / LVGL dependencies - builds on the host as-is
+
+// Cuts a baseline YCbCr JPEG with no restart markers at an MCU row.
+// The entropy data up to the cut is Huffman decoded (no dequantising or IDCT)
+// to find where the row starts and what the DC predictors are there. The lower
+// band is then a standalone JPEG: the same headers with a new height, the first
+// MCU re-encoded with absolute DCs and the rest of the scan copied bit for bit.
+// A DC table missing a category the absolute values need gets it added on
+// codes longer than any it already has, so every existing code stays valid
+class JpegSplit {
+public:
+    // Headers are ones lowerBand can cut - 3 components, only luma subsampled,
+    // no restart markers, Huffman tables with room to grow
+    static bool supported(const uint8_t* jpg, size_t len);
+
+    // MCU rows from_row onwards as their own JPEG, malloc'd. nullptr if it can't be cut there
+    static uint8_t* lowerBand(const uint8_t* jpg, size_t len, uint16_t from_row, size_t& out_len);
+};
+
+
+
+#endif //JPEGSPLIT_H
@@ -0,0 +1,143 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "TextLayer.h"
+
+static void scroll_anim_cb(void* var, int32_t v) {
+    lv_img_set_offset_x((lv_obj_t*)var, v);
+}
+
+bool TextLayer::render(const char* txt, const lv_font_t* f, lv_color_t c) {
+    if (dsc.data && font == f && colour.full == c.full && text == txt) return true;
+
+    lv_coord_t text_w = lv_txt_get_width(txt, strlen(txt), f, 0, LV_TEXT_FLAG_NONE);
+    uint32_t w = text_w + TEXT_LAYER_GAP;
+    uint32_t h = lv_font_get_line_height(f);
+    if (w > TEXT_LAYER_MAX_WIDTH) return false;
+
+    // The cache is keyed on &dsc - drop the old entry before its data or size changes
+    if (dsc.data) lv_img_cache_invalidate_src(&dsc);
+
+    uint32_t needed = w * h * LV_IMG_PX_SIZE_ALPHA_BYTE;
+    if (buf && buf_size < needed) {
+        free(buf);
+        buf = nullptr;
+    }
+    if (!buf) {
+        buf = (uint8_t*)ps_malloc(needed);
+        buf_size = buf ? needed : 0;
+    }
+    if (!buf) {
+        dsc.data = nullptr;
+        return false;
+    }
+
+    // Colour everywhere, coverage in the alpha byte
+    dsc.header.always_zero = 0;
+    dsc.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    dsc.header.w = w;
+    dsc.header.h = h;
+    dsc.data_size = needed;
+    dsc.data = buf;
+
+    for (uint32_t i = 0; i < w * h; i++) {
+        uint8_t* px = &buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE];
+        px[0] = c.full & 0xFF;
+        px[1] = c.full >> 8;
+        px[2] = 0;
+    }
+
+    // Same baseline maths as lv_draw_letter
+    int32_t pen_x = 0;
+    uint32_t i = 0;
+    while (txt[i]) {
+        uint32_t letter;
+        uint32_t letter_next;
+        _lv_txt_encoded_letter_next_2(txt, &letter, &letter_next, &i);
+
+        lv_font_glyph_dsc_t g;
+        if (!lv_font_get_glyph_dsc(f, &g, letter, letter_next)) continue;
+
+        const lv_font_t* glyph_font = g.resolved_font ? g.resolved_font : f;
+        const uint8_t* bitmap = lv_font_get_glyph_bitmap(glyph_font, letter);
+        if (bitmap && g.box_w && g.box_h) {
+            int32_t y = (glyph_font->line_height - glyph_font->base_line) - g.box_h - g.ofs_y;
+            blitGlyph(g, bitmap, pen_x + g.ofs_x, y);
+        }
+        pen_x += g.adv_w;
+    }
+
+    text = txt;
+    font = f;
+    colour = c;
+    if (obj) lv_img_set_src(obj, &dsc);
+    return true;
+}
+
+void TextLayer::blitGlyph(const lv_font_glyph_dsc_t& g, const uint8_t* bitmap, int32_t x0, int32_t y0) {
+    // Glyph bits are packed MSB first with no row padding
+    uint8_t bpp = g.bpp;
+    uint8_t max = (1 << bpp) - 1;
+    uint32_t bit = 0;
+
+    for (int32_t y = 0; y < g.box_h; y++) {
+        for (int32_t x = 0; x < g.box_w; x++, bit += bpp) {
+            uint8_t byte = bitmap[bit >> 3];
+            uint8_t value = (byte >> (8 - bpp - (bit & 7))) & max;
+
+            int32_t px = x0 + x;
+            int32_t py = y0 + y;
+            if (!value || px < 0 || py < 0 || px >= dsc.header.w || py >= dsc.header.h) continue;
+
+            uint8_t* a = &buf[(py * dsc.header.w + px) * LV_IMG_PX_SIZE_ALPHA_BYTE + 2];
+            uint8_t opa = value * 255 / max;
+            if (opa > *a) *a = opa;     // Overlapping kerned glyphs keep the stronger edge
+        }
+    }
+}
+
+void TextLayer::show(lv_obj_t* l) {
+    if (!dsc.data || !l) return;
+
+    if (!obj || label != l) {
+        hide();
+        if (obj) lv_obj_del(obj);
+        obj = lv_img_create(lv_obj_get_parent(l));
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_IGNORE_LAYOUT | LV_OBJ_FLAG_FLOATING);
+        label = l;
+    }
+
+    lv_img_set_src(obj, &dsc);
+    lv_obj_update_layout(label);
+    lv_obj_set_size(obj, lv_obj_get_width(label), dsc.header.h);
+    lv_obj_align_to(obj, label, LV_ALIGN_TOP_LEFT, 0, 0);
+    lv_obj_add_flag(label, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+
+    lv_anim_del(obj, (lv_anim_exec_xcb_t)scroll_anim_cb);
+    lv_img_set_offset_x(obj, 0);
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, obj);
+    lv_anim_set_values(&a, 0, -(int32_t)dsc.header.w);   // A whole tile lands back where it started
+    lv_anim_set_time(&a, dsc.header.w * TEXT_LAYER_MS_PER_PX);
+    lv_anim_set_exec_cb(&a, (lv_anim_exec_xcb_t)scroll_anim_cb);
+    lv_anim_set_path_cb(&a, lv_anim_path_linear);
+
+    // Loop
+    lv_anim_set_delay(&a, 2000);
+    lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+    lv_anim_set_repeat_delay(&a, 30000);
+
+    lv_anim_start(&a);
+}
+
+void TextLayer::hide() {
+    if (obj) {
+        lv_anim_del(obj, (lv_anim_exec_xcb_t)scroll_anim_cb);
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    }
+    if (label) lv_obj_clear_flag(label, LV_OBJ_FLAG_HIDDEN);
+}
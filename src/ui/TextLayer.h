@@ -0,0 +1,50 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef TEXTLAYER_H
+#define TEXTLAYER_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+#define TEXT_LAYER_GAP 40           // Space before the text comes round again
+#define TEXT_LAYER_MAX_WIDTH 4096
+#define TEXT_LAYER_MS_PER_PX 30
+
+// A line of text rasterised once into an RGB565 + A8 bitmap, then scrolled by
+// moving an lv_img's offset - each frame is a plain blit rather than every
+// glyph being rendered again. The bitmap includes the gap and tiles, so the
+// scroll wraps round seamlessly
+class TextLayer {
+public:
+    // Only re-renders when the text, font or colour change
+    bool render(const char* text, const lv_font_t* font, lv_color_t colour);
+
+    // Swaps the label for the scrolling layer
+    void show(lv_obj_t* label);
+    void hide();
+
+    // Screen was deleted - the layer's object went with it
+    void detach() { obj = nullptr; label = nullptr; }
+
+    uint16_t getWidth() const { return dsc.header.w; }
+
+private:
+    lv_img_dsc_t dsc = {};
+    uint8_t* buf = nullptr;
+    uint32_t buf_size = 0;
+
+    String text;
+    const lv_font_t* font = nullptr;
+    lv_color_t colour;
+
+    lv_obj_t* obj = nullptr;
+    lv_obj_t* label = nullptr;
+
+    void blitGlyph(const lv_font_glyph_dsc_t& g, const uint8_t* bitmap, int32_t x, int32_t y);
+};
+
+
+
+#endif //TEXTLAYER_H
@@ -7,7 +7,13 @@
 #include "global_state.h"
 #include "network/WifiManager.h"
 #include "spotify/SpotifyManager.h"
+#include "system/BootSequencer.h"
+#include "system/Lifecycle.h"
 #include "system/SystemManager.h"
+#include "system/TraceLog.h"
+#include "ArtScaler.h"
+#include "ArtPipeline.h"
+#include "JpegDecoder.h"
 
 // For Manual WiFi Todo: Move?
 struct WiFiLoginFields {
@@ -20,6 +26,8 @@ LV_IMG_DECLARE(CurrentDeviceLogo);
 
 static uint8_t tjpg_workspace[4096];
 
+#define NETWORK_ROW_HEIGHT 70
+
 lv_img_dsc_t UIManager::album_dsc;
 uint16_t* UIManager::album_buffer = nullptr;
 uint16_t UIManager::current_w = 0;
@@ -27,10 +35,17 @@ uint16_t UIManager::current_h = 0;
 
 static lv_color_t* zoom_buffer = nullptr;
 static uint32_t current_zoom_buf_size = 0;
+static String album_request_url;   // What the art in album_dsc was requested as
 
-void UIManager::updateAlbumArt(uint8_t* jpgData, size_t len, short t_size) {
+void UIManager::updateAlbumArt(uint8_t* jpgData, size_t len, short t_size, const String& request_url) {
     if (!jpgData || t_size <= 0) return;
 
+    // A download that lost the race with a track change
+    if (request_url != art_request_url) {
+        TRACE(TRACE_ART_STALE);
+        return;
+    }
+
     // 1. Manage the RAW JPG buffer
     static uint8_t* stable_jpg = nullptr;
     if (stable_jpg) { free(stable_jpg); stable_jpg = nullptr; }
@@ -43,6 +58,7 @@ void UIManager::updateAlbumArt(uint8_t* jpgData, size_t len, short t_size) {
     album_dsc.header.cf = LV_IMG_CF_RAW;
     album_dsc.data_size = len;
     album_dsc.data = stable_jpg;
+    album_request_url = request_url;
 
     // Clear cache so the decoder sees the new dimensions/data
     lv_img_cache_invalidate_src(&album_dsc);
@@ -53,35 +69,24 @@ void UIManager::updateAlbumArt(uint8_t* jpgData, size_t len, short t_size) {
 
         // --- SAFETY CHECK ---
         if (UIManager::getInstance().ui_album_art == nullptr) {
-            Serial.println("UI: Art decode cancelled - ui_album_art is null");
+            TRACE(TRACE_ART_CANCELLED);
             return;
         }
 
 
-        lv_img_header_t header;
-        if (lv_img_decoder_get_info(&UIManager::album_dsc, &header) != LV_RES_OK) {
-            Serial.println("Error: JPG Header decode failed");
-            return;
-        }
-
-        // --- STEP A: DECODE JPG TO TEMP BITMAP ---
-        uint32_t raw_bmp_size = LV_CANVAS_BUF_SIZE_TRUE_COLOR(header.w, header.h);
-        lv_color_t* raw_bmp_buf = (lv_color_t*)ps_malloc(raw_bmp_size);
-        if (!raw_bmp_buf) return;
+        const uint8_t* jpg = UIManager::album_dsc.data;
+        size_t jpg_len = UIManager::album_dsc.data_size;
 
-        lv_obj_t* temp_canvas = lv_canvas_create(lv_scr_act());
-        lv_canvas_set_buffer(temp_canvas, raw_bmp_buf, header.w, header.h, LV_IMG_CF_TRUE_COLOR);
-        lv_canvas_fill_bg(temp_canvas, lv_color_hex(0x000000), LV_OPA_COVER);
+#ifdef JPEG_DECODE_BENCHMARK
+        JpegDecoder::benchmark(jpg, jpg_len);
+#endif
 
-        lv_draw_img_dsc_t decode_dsc;
-        lv_draw_img_dsc_init(&decode_dsc);
-        lv_canvas_draw_img(temp_canvas, 0, 0, &UIManager::album_dsc, &decode_dsc);
-
-        // --- STEP B: MANAGE DYNAMIC ZOOM BUFFER ---
+        // --- STEP A: MANAGE DYNAMIC ZOOM BUFFER ---
         uint32_t needed_size = LV_CANVAS_BUF_SIZE_TRUE_COLOR(target_dim, target_dim);
 
         // If buffer doesn't exist or is the wrong size, reallocate
         if (zoom_buffer && current_zoom_buf_size != needed_size) {
+            UIManager::getInstance().art_frame.release();
             free(zoom_buffer);
             zoom_buffer = nullptr;
         }
@@ -91,34 +96,23 @@ void UIManager::updateAlbumArt(uint8_t* jpgData, size_t len, short t_size) {
             current_zoom_buf_size = needed_size;
         }
 
-        if (!zoom_buffer) {
-            free(raw_bmp_buf);
-            lv_obj_del(temp_canvas);
+        if (!zoom_buffer) return;
+
+        // --- STEP B: DECODE, SCALE + PALETTE IN ONE PASS ---
+        ArtPalette palette;
+        ArtPipelineStats stats;
+        if (!ArtPipeline::run(jpg, jpg_len, (uint16_t*)zoom_buffer, target_dim, palette, stats)) {
+            TRACE(TRACE_ART_DECODE_FAILED);
             return;
         }
 
-        // --- STEP C: SCALE TO TARGET SIZE ---
-        lv_obj_t* final_canvas = lv_canvas_create(lv_scr_act());
-        lv_canvas_set_buffer(final_canvas, zoom_buffer, target_dim, target_dim, LV_IMG_CF_TRUE_COLOR);
-        lv_canvas_fill_bg(final_canvas, lv_color_hex(0x000000), LV_OPA_COVER);
-
-        lv_img_dsc_t decoded_bmp_dsc;
-        decoded_bmp_dsc.header.always_zero = 0;
-        decoded_bmp_dsc.header.w = header.w;
-        decoded_bmp_dsc.header.h = header.h;
-        decoded_bmp_dsc.header.cf = LV_IMG_CF_TRUE_COLOR;
-        decoded_bmp_dsc.data = (const uint8_t*)raw_bmp_buf;
-        decoded_bmp_dsc.data_size = raw_bmp_size;
-
-        lv_draw_img_dsc_t scale_dsc;
-        lv_draw_img_dsc_init(&scale_dsc);
+        TRACE(TRACE_ART_DECODED, ((uint32_t)stats.fused << 16) | (uint16_t)target_dim, stats.us);
+        TRACE(TRACE_ART_PSRAM, stats.psram_bytes_est, stats.unfused_psram_bytes_est);
 
-        // Calculate aspect-fill scale
-        float scale = (float)target_dim / (float)(header.w > header.h ? header.w : header.h);
-        scale_dsc.zoom = (uint16_t)(scale * 256.0f);
-        scale_dsc.antialias = 1;
-
-        lv_canvas_draw_img(final_canvas, 0, 0, &decoded_bmp_dsc, &scale_dsc);
+        // Built-in art keeps its own colour
+        if (spotifyState.current_art_asset == ASSET_NONE && palette.valid) {
+            spotifyState.album_background_cover = SpotifyManager::calculateSmartBackground(palette);
+        }
 
         // --- STEP D: FINALIZE ---
         static lv_img_dsc_t final_dsc;
@@ -129,169 +123,348 @@ void UIManager::updateAlbumArt(uint8_t* jpgData, size_t len, short t_size) {
         final_dsc.data_size = needed_size;
         final_dsc.data = (const uint8_t*)zoom_buffer;
 
-        if (UIManager::getInstance().ui_album_art != nullptr) {
-            lv_img_set_src(UIManager::getInstance().ui_album_art, &final_dsc);
-            lv_obj_set_size(UIManager::getInstance().ui_album_art, target_dim, target_dim);
+        // Static art only gets decoded once - keep the scaled pixels for next time
+        UIManager& ui = UIManager::getInstance();
+        if (ui.bake_asset != ASSET_NONE && album_request_url == AssetStore::getInstance().getSourceUrl(ui.bake_asset) &&
+            target_dim == AssetStore::getInstance().getSize(ui.bake_asset)) {
+            AssetStore::getInstance().bake(ui.bake_asset, zoom_buffer, target_dim, target_dim);
+            ui.bake_asset = ASSET_NONE;
+        }
+
+        ui.presentAlbumArt(&final_dsc);
 
-            lv_label_set_text(UIManager::getInstance().ui_song_title, spotifyState.current_track_title.c_str());
-            lv_label_set_text(UIManager::getInstance().ui_song_artist, spotifyState.current_track_artist.c_str());
-            lv_label_set_text(UIManager::getInstance().ui_device_name, spotifyState.current_track_device_name.c_str());
+    }, (void*)(uintptr_t)t_size);
 
-            lv_obj_set_style_bg_color(UIManager::getInstance().current_screen, lv_color_hex(spotifyState.album_background_cover), 0);
-            UIManager::getInstance().resetMarquee(UIManager::getInstance().ui_song_title);
-            Serial.println("UI: Complete atomic update finished.");
+}
+
+
+void UIManager::presentAlbumArt(const lv_img_dsc_t* dsc) {
+    if (ui_album_art == nullptr) return;
+
+    // The frame is baked into our own copy so baked assets stay untouched
+    if (dsc->data != (const uint8_t*)zoom_buffer) {
+        if (zoom_buffer && current_zoom_buf_size != dsc->data_size) {
+            art_frame.release();
+            free(zoom_buffer);
+            zoom_buffer = nullptr;
         }
+        if (!zoom_buffer) {
+            zoom_buffer = (lv_color_t*)ps_malloc(dsc->data_size);
+            current_zoom_buf_size = zoom_buffer ? dsc->data_size : 0;
+        }
+        if (!zoom_buffer) return;
+        memcpy(zoom_buffer, dsc->data, dsc->data_size);
+    }
 
-        // Cleanup temporary decoding objects
-        lv_obj_del(temp_canvas);
-        lv_obj_del(final_canvas);
-        free(raw_bmp_buf);
+    static lv_img_dsc_t framed_dsc;
+    framed_dsc = *dsc;
+    framed_dsc.data = (const uint8_t*)zoom_buffer;
 
-        Serial.printf("UI: Album Art updated to %dx%d\n", target_dim, target_dim);
+    art_frame.capture(zoom_buffer, dsc->header.w, dsc->header.h);
+    art_frame.bake(lv_color_hex(spotifyState.album_background_cover));
 
-    }, (void*)(uintptr_t)t_size);
+    lv_img_set_src(ui_album_art, &framed_dsc);
+    lv_obj_set_size(ui_album_art, dsc->header.w, dsc->header.h);
+    lv_obj_invalidate(ui_album_art);
+
+    lv_label_set_text(ui_song_title, spotifyState.current_track_title.c_str());
+    lv_label_set_text(ui_song_artist, spotifyState.current_track_artist.c_str());
+    lv_label_set_text(ui_device_name, spotifyState.current_track_device_name.c_str());
+
+    lv_obj_set_style_bg_color(current_screen, lv_color_hex(spotifyState.album_background_cover), 0);
+    resetMarquee(ui_song_title);
+    resetMarquee(ui_song_artist);
+    TRACE(TRACE_ART_PRESENTED, dsc->header.w);
+    BootSequencer::getInstance().mark(BOOT_MILESTONE_FIRST_ART);
+}
+
+// Baked asset straight from flash if the state names one, otherwise download
+void UIManager::requestArt(short t_size) {
+    TRACE(TRACE_UI_ART_REQUEST, t_size);
+
+    AssetId asset = (AssetId)spotifyState.current_art_asset;
+    if (asset == ASSET_NONE && spotifyState.current_track_url.isEmpty()) asset = ASSET_NOT_PLAYING;
 
+    if (asset == ASSET_NONE) {
+        bake_asset = ASSET_NONE;
+        art_request_url = spotifyState.current_track_url;
+        SpotifyManager::getInstance().requestAlbumArt(art_request_url, t_size);
+        return;
+    }
+
+    const lv_img_dsc_t* dsc = AssetStore::getInstance().get(asset);
+    if (dsc) {
+        bake_asset = ASSET_NONE;
+        art_request_url = "";
+        presentAlbumArt(dsc);
+        return;
+    }
+
+    // Not baked yet - fetch the source once, the decode stores it
+    TRACE(TRACE_UI_ASSET_FETCH, asset);
+    bake_asset = asset;
+    art_request_url = AssetStore::getInstance().getSourceUrl(asset);
+    SpotifyManager::getInstance().requestAlbumArt(art_request_url, AssetStore::getInstance().getSize(asset));
 }
 
 
+#ifdef ART_SCALER_BENCHMARK
+// 640 -> 365, the usual album art case: LVGL canvas zoom against ArtScaler
+static void benchmarkArtScaler() {
+    const int src_dim = 640;
+    const int dst_dim = 365;
+    const int runs = 5;
+
+    lv_color_t* src = (lv_color_t*)ps_malloc(src_dim * src_dim * sizeof(lv_color_t));
+    lv_color_t* dst = (lv_color_t*)ps_malloc(dst_dim * dst_dim * sizeof(lv_color_t));
+    if (!src || !dst) {
+        free(src);
+        free(dst);
+        return;
+    }
+
+    for (int y = 0; y < src_dim; y++) {
+        for (int x = 0; x < src_dim; x++) {
+            src[y * src_dim + x] = lv_color_make(x * 255 / src_dim, y * 255 / src_dim, (x ^ y) & 0xFF);
+        }
+    }
+
+    lv_img_dsc_t src_dsc = {};
+    src_dsc.header.cf = LV_IMG_CF_TRUE_COLOR;
+    src_dsc.header.w = src_dim;
+    src_dsc.header.h = src_dim;
+    src_dsc.data = (const uint8_t*)src;
+    src_dsc.data_size = src_dim * src_dim * sizeof(lv_color_t);
+
+    lv_obj_t* canvas = lv_canvas_create(lv_scr_act());
+    lv_canvas_set_buffer(canvas, dst, dst_dim, dst_dim, LV_IMG_CF_TRUE_COLOR);
+    lv_draw_img_dsc_t zoom_dsc;
+    lv_draw_img_dsc_init(&zoom_dsc);
+    zoom_dsc.zoom = (uint16_t)(256.0f * dst_dim / src_dim);
+    zoom_dsc.antialias = 1;
+
+    uint32_t start = micros();
+    for (int i = 0; i < runs; i++) lv_canvas_draw_img(canvas, 0, 0, &src_dsc, &zoom_dsc);
+    uint32_t lvgl_us = (micros() - start) / runs;
+    lv_obj_del(canvas);
+
+    start = micros();
+    for (int i = 0; i < runs; i++) {
+        ArtScaler::scale((const uint16_t*)src, src_dim, src_dim, (uint16_t*)dst, dst_dim, dst_dim, dst_dim, ART_SCALE_AREA);
+    }
+    uint32_t area_us = (micros() - start) / runs;
+
+    start = micros();
+    for (int i = 0; i < runs; i++) {
+        ArtScaler::scale((const uint16_t*)src, src_dim, src_dim, (uint16_t*)dst, dst_dim, dst_dim, dst_dim, ART_SCALE_BILINEAR);
+    }
+    uint32_t bilinear_us = (micros() - start) / runs;
+
+    Serial.printf("Bench: 640->365 lvgl zoom %luus, area %luus, bilinear %luus\n", lvgl_us, area_us, bilinear_us);
+
+    free(src);
+    free(dst);
+}
+#endif
+
 void UIManager::init() {
     initStyles();
+
+    // Screen routing - WiFi shows its screen straight away, Spotify waits for the link to settle
+    bind(FIELD_WIFI_STATUS, &UIManager::applyWifiStatus, false, true);
+    bind(FIELD_SPOTIFY_STATUS, &UIManager::applySpotifyStatus, false);
     lv_split_jpeg_init();
     lv_img_cache_set_size(4);
 
+#ifdef ART_SCALER_BENCHMARK
+    benchmarkArtScaler();
+#endif
+
 }
 
 void UIManager::update() {
-    static bool first_run = true;
-    static WifiStatus last_wifi_status = WIFI_IDLE;
-    static SpotifyStatus last_spotify_status = SPOTIFY_IDLE;
-    static uint32_t connectedStartTime = 0;
-
-    // --- WIFI ----
-    if (networkState.status != last_wifi_status || first_run) {
-        switch (networkState.status) {
-            case WIFI_IDLE:
-                showOnboarding();
-                break;
-
-            case WIFI_CONNECTING:
-                showSpinner("Connecting to " + networkState.selected_ssid);
-                break;
-
-            case WIFI_SCANNING:
-                showSpinner("Searching for networks...");
-                break;
-
-            case WIFI_SCAN_RESULTS:
-                showNetworkList(networkState.found_ssids);
-                break;
-
-            case WIFI_CONNECTED:
-                showContextScreen("WiFi Connected!");
-                break;
-
-            case WIFI_ERROR:
-                showWifiError();
-                break;
-        }
+    if (systemState.boot_failed) {
+        static bool failure_shown = false;
+        if (!failure_shown) showFailure();
+        failure_shown = true;
+        return;
+    }
 
-        if (networkState.status == WIFI_CONNECTED) {
-            connectedStartTime = millis();
-        } else {
-            connectedStartTime = 0;
-        }
+    applyBindings();
 
-        last_wifi_status = networkState.status;
+    // Old screen is only deleted on the next lv_timer_handler, so this is just the new one
+    if (screen_heap_free) logScreenCost(current_screen);
+}
+
+// --- State Bindings ---
+void UIManager::bind(StateField field, void (UIManager::*apply)(), bool screen, bool apply_now) {
+    if (binding_count >= UI_MAX_BINDINGS) {
+        Serial.println("UI: Binding table full");
+        return;
     }
 
-    // --- TRANSITION ---
-    bool wifi_ready_for_spotify = false;
-    if (networkState.status == WIFI_CONNECTED && connectedStartTime != 0) {
-        if (millis() - connectedStartTime > 1500) {
-            wifi_ready_for_spotify = true;
-            SpotifyManager::getInstance().buildAuthURL(); // Todo: Make this work but not infinite
-
-            if (spotifyState.status == SPOTIFY_IDLE) {
-                if (spotifyState.refresh_token.length() > 0) spotifyState.status = SPOTIFY_INITIALIZING;
-                else if (systemState.spotify_linked && spotifyState.refresh_token.length() == 0) spotifyState.status = SPOTIFY_LINK_ERROR;
-                else spotifyState.status = SPOTIFY_NEED_LINK;
-            }
-        }
+    // Widgets are built from the current state, so they only need later changes
+    uint32_t version = StateBus::getInstance().version(field);
+
+    Binding& b = bindings[binding_count++];
+    b.field = field;
+    b.apply = apply;
+    b.screen = screen;
+    b.seen = apply_now ? version - 1 : version;
+    bindings_dirty = true;  // Make sure the next pass looks at it
+}
+
+void UIManager::unbindScreen() {
+    int kept = 0;
+    for (int i = 0; i < binding_count; i++) {
+        if (!bindings[i].screen) bindings[kept++] = bindings[i];
     }
+    binding_count = kept;
+    screen_generation++;
+}
 
-    // --- SPOTIFY ---
-    if (wifi_ready_for_spotify && (spotifyState.status != last_spotify_status)) {
-        switch (spotifyState.status) {
-            case SPOTIFY_NEED_LINK:
-                showSpotifyLinking(spotifyState.auth_url.c_str());
-                // Needs to start a web server and listen
-                break;
+void UIManager::applyBindings() {
+    StateBus& bus = StateBus::getInstance();
+
+    // Nothing published since the last pass
+    uint32_t sequence = bus.getSequence();
+    if (sequence == bus_seen && !bindings_dirty) return;
+    bus_seen = sequence;
+    bindings_dirty = false;
+
+    // Applying can swap screens, which rebuilds the table - work from a copy
+    Binding changed[UI_MAX_BINDINGS];
+    int count = 0;
+    for (int i = 0; i < binding_count; i++) {
+        uint32_t version = bus.version(bindings[i].field);
+        if (version == bindings[i].seen) continue;
+        bindings[i].seen = version;
+        changed[count++] = bindings[i];
+    }
 
-            case SPOTIFY_AUTHENTICATING:
-                showSpinner("Authenticating with Spotify...");
-                break;
+    uint32_t generation = screen_generation;
+    for (int i = 0; i < count; i++) {
+        // That screen's widgets are gone
+        if (changed[i].screen && generation != screen_generation) continue;
+        (this->*changed[i].apply)();
+    }
+}
 
-            case SPOTIFY_INITIALIZING:
-                showSpinner("Resuming Spotify Session...");
+void UIManager::applyWifiStatus() {
+    switch (networkState.status) {
+        case WIFI_IDLE:
+            showOnboarding();
+            break;
+
+        case WIFI_CONNECTING:
+            showSpinner("Connecting to " + networkState.selected_ssid);
+            break;
+
+        case WIFI_SCANNING:
+            showSpinner("Searching for networks...");
+            break;
+
+        case WIFI_SCAN_RESULTS:
+            ui_scan_version = WifiManager::getInstance().getNetworks(ui_networks);
+            showNetworkList(ui_networks);
+            break;
+
+        case WIFI_CONNECTED:
+            // Onboarding keeps this up for a moment before Spotify takes over
+            if (Lifecycle::wifiSettleMs() > 0) showContextScreen("WiFi Connected!");
+            break;
+
+        case WIFI_ERROR:
+            showWifiError();
+            break;
+    }
+}
 
-            case SPOTIFY_READY:
-                showMainPlayer();
-                if (ui_song_title != nullptr)
-                    resetMarquee(ui_song_title);
+void UIManager::applySpotifyStatus() {
+    if (!Lifecycle::getInstance().isWifiSettled()) return;   // Republished once it is
 
-                break;
+    switch (spotifyState.status) {
+        case SPOTIFY_NEED_LINK:
+            SpotifyManager::getInstance().buildAuthURL(); // Memoised - only rebuilds on IP / client id change
+            showSpotifyLinking(spotifyState.auth_url.c_str());
+            // Needs to start a web server and listen
+            break;
 
-            case SPOTIFY_LINK_ERROR:
-                showSpotifyLinkError();
-                break;
+        case SPOTIFY_AUTHENTICATING:
+            showSpinner("Authenticating with Spotify...");
+            break;
 
-            case SPOTIFY_ERROR:
-                showSpotifyError();
-                //showContextScreen("Spotify Error");
-                break;
+        case SPOTIFY_INITIALIZING:
+            showSpinner("Resuming Spotify Session...");
 
-            default: break;
-        }
-        last_spotify_status = spotifyState.status;
-    }
+        case SPOTIFY_READY:
+            showMainPlayer();
+            break;
 
-    if (spotifyState.status == SPOTIFY_READY && wifi_ready_for_spotify && ui_song_title != nullptr) {
-        static uint32_t last_ui_colour = 0;
-        static String last_ui_device_name = "INIT";
+        case SPOTIFY_LINK_ERROR:
+            showSpotifyLinkError();
+            break;
 
+        case SPOTIFY_ERROR:
+            showSpotifyError();
+            //showContextScreen("Spotify Error");
+            break;
 
-        if (spotifyState.needs_text_update) {
-            Serial.println("UI: Same album detected, updating text labels immediately.");
-            lv_label_set_text(ui_song_title, spotifyState.current_track_title.c_str());
-            lv_label_set_text(ui_song_artist, spotifyState.current_track_artist.c_str());
-            lv_label_set_text(ui_device_name, spotifyState.current_track_device_name.c_str());
+        default: break;
+    }
+}
 
-            resetMarquee(ui_song_title);
-            spotifyState.needs_text_update = false; // Flag consumed
-        }
+void UIManager::applyScanResults() {
+    // More channels scanned since the list was drawn
+    if (networkState.scan_version != ui_scan_version) refreshNetworkList();
+}
 
-        if (spotifyState.needs_art_update) {
-            Serial.println("UI: New art needed, starting download sync...");
-            SpotifyManager::getInstance().loadAlbumArt(spotifyState.current_track_url, 365);
-            spotifyState.needs_art_update = false; // Flag consumed
-        }
+void UIManager::applyTrackText() {
+    TRACE(TRACE_UI_TRACK_TEXT);
+    lv_label_set_text(ui_song_title, spotifyState.current_track_title.c_str());
+    lv_label_set_text(ui_song_artist, spotifyState.current_track_artist.c_str());
 
+    resetMarquee(ui_song_title);
+    resetMarquee(ui_song_artist);
+}
 
-        if (!spotifyState.needs_art_update && spotifyState.album_background_cover != last_ui_colour) {
-            last_ui_colour = spotifyState.album_background_cover;
-            Serial.printf("UI: Applying new pallete colour: 0x%06X\n", last_ui_colour);
-            lv_obj_set_style_bg_color(current_screen, lv_color_hex(last_ui_colour), 0);
-        }
+void UIManager::applyTrackArt() {
+    requestArt(365);
+}
 
-        // Check device name change
-        if (spotifyState.current_track_device_name != last_ui_device_name) {
-            last_ui_device_name = spotifyState.current_track_device_name;
-            Serial.println("UI: Device change detected, refreshing label...");
-            lv_label_set_text(ui_device_name, spotifyState.current_track_device_name.c_str());
-        }
+void UIManager::applyArtReady() {
+    // Art downloaded on the art task
+    uint8_t* art_data;
+    size_t art_len;
+    short art_size;
+    String request_url;
+    if (SpotifyManager::getInstance().takeAlbumArt(art_data, art_len, art_size, request_url)) {
+        updateAlbumArt(art_data, art_len, art_size, request_url);
+        free(art_data);
     }
+}
+
+void UIManager::applyBackground() {
+    uint32_t colour = spotifyState.album_background_cover;
+    TRACE(TRACE_UI_BACKGROUND, colour);
+    lv_obj_set_style_bg_color(current_screen, lv_color_hex(colour), 0);
 
-    first_run = false;
+    // Corners were blended against the old colour
+    if (art_frame.isCaptured() && ui_album_art != nullptr) {
+        art_frame.bake(lv_color_hex(colour));
+        lv_obj_invalidate(ui_album_art);
+    }
+}
+
+void UIManager::applyDeviceName() {
+    TRACE(TRACE_UI_DEVICE_NAME);
+    lv_label_set_text(ui_device_name, spotifyState.current_track_device_name.c_str());
+}
+
+void UIManager::applyLinkStatus() {
+    // Link monitor is reconnecting in the background - keep the player, flag it
+    if (networkState.link_lost) lv_obj_clear_flag(ui_link_status, LV_OBJ_FLAG_HIDDEN);
+    else lv_obj_add_flag(ui_link_status, LV_OBJ_FLAG_HIDDEN);
 }
 
 // --- Callbacks - Errors ----
@@ -323,15 +496,15 @@ static void errorEventHandler(lv_event_t * e) {
         }
         else if (btn == spotify_error_retry_btn_ptr) {
             // Try reconnecting to spotify - this being set should update everything
-            spotifyState.status = SPOTIFY_AUTHENTICATING;
+            Lifecycle::getInstance().setSpotify(SPOTIFY_AUTHENTICATING, "retry pressed");
         }
         else if (btn == spotify_error_relink_btn_ptr ||
                  btn == spotify_link_error_btn_ptr)
         {
             // Re-link spotify
             SystemManager::getInstance().resetSpotifyTokens(); // Wipe saved tokens
-            spotifyState.status = SPOTIFY_NEED_LINK; // Re onboard
             spotifyState.refresh_token = ""; // Clear local token
+            Lifecycle::getInstance().setSpotify(SPOTIFY_NEED_LINK, "relink pressed"); // Re onboard
         }
     }
 }
@@ -374,14 +547,13 @@ static void wifiJoinEventHandler(lv_event_t * e) {
 void UIManager::showFailure() {
     clearScreen();
 
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     createLogo(current_screen, &font_gotham_medium_80, LV_ALIGN_TOP_MID, 0, 35);
 
     lv_obj_t* label = lv_label_create(current_screen);
     lv_label_set_text(label, "Something went wrong!");
-    lv_obj_set_style_text_color(label, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_text_font(label, &font_gotham_medium_60, 0);
+    lv_obj_add_style(label, &style_text_title, 0);
     lv_obj_align(label, LV_ALIGN_CENTER, 0, 0);
 
     error_restart_btn_ptr = createSpotifyBtn(
@@ -392,40 +564,37 @@ void UIManager::showFailure() {
 void UIManager::showSplashScreen() {
     clearScreen();
 
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     createLogo(current_screen, &font_gotham_medium_80, LV_ALIGN_CENTER, 0, 0);
 }
 
 void UIManager::showSpinner(const String &msg) {
     clearScreen();
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     lv_obj_t* spinner = lv_spinner_create(current_screen, 1000, 60);
     lv_obj_set_size(spinner, 80, 80);
     lv_obj_center(spinner);
 
-    lv_obj_set_style_arc_color(spinner, SPOTIFY_GREEN, LV_PART_INDICATOR);
-    lv_obj_set_style_arc_width(spinner, 8, LV_PART_MAIN);
-    lv_obj_set_style_arc_width(spinner, 8, LV_PART_INDICATOR);
+    lv_obj_add_style(spinner, &style_spinner, LV_PART_MAIN);
+    lv_obj_add_style(spinner, &style_spinner_indicator, LV_PART_INDICATOR);
 
     lv_obj_t* label = lv_label_create(current_screen);
     lv_label_set_text(label, msg.c_str());
-    lv_obj_set_style_text_font(label, &font_gotham_medium_40, 0);
-    lv_obj_set_style_text_color(label, SPOTIFY_WHITE, 0);
+    lv_obj_add_style(label, &style_text_heading, 0);
     lv_obj_align(label, LV_ALIGN_CENTER, 0, 80);
 }
 
 void UIManager::showContextScreen(const String &msg) {
     clearScreen();
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     createLogo(current_screen, &font_gotham_medium_80, LV_ALIGN_CENTER, 0, 0);
 
     lv_obj_t* context = lv_label_create(current_screen);
     lv_label_set_text(context, msg.c_str());
-    lv_obj_set_style_text_font(context, &font_gotham_medium_20, 0);
-    lv_obj_set_style_text_color(context, SPOTIFY_WHITE, 0);
+    lv_obj_add_style(context, &style_text_caption, 0);
     lv_obj_align(context, LV_ALIGN_BOTTOM_MID, 0, -18);
 }
 
@@ -435,97 +604,83 @@ void UIManager::showContextScreen(const String &msg) {
 void UIManager::showOnboarding() {
     clearScreen();
 
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     // Header Title
     lv_obj_t* title = lv_label_create(current_screen);
     lv_label_set_text(title, "Let's get connected!");
-    lv_obj_set_style_text_color(title, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_text_font(title, &font_gotham_medium_60, 0);
+    lv_obj_add_style(title, &style_text_title, 0);
     lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 30);
 
     // Message
     lv_obj_t * body = lv_label_create(current_screen);
     lv_label_set_text(body, "Press the buton below to search for \nlocal networks. \n\nFind yours and connect!");
-    lv_obj_set_style_text_color(body, SPOTIFY_GREY, 0);
-    lv_obj_set_style_text_font(body, &font_gotham_medium_40, 0);
+    lv_obj_add_style(body, &style_text_body, 0);
     lv_obj_align(body, LV_ALIGN_TOP_LEFT, 30, 115);
 
     get_connected_btn_ptr = createSpotifyBtn(current_screen, onboardingEventHandler, "Get Connected!", LV_ALIGN_BOTTOM_MID, 0, -32, true);
 }
 
-void UIManager::showNetworkList(const std::vector<String>& networks) {
+void UIManager::showNetworkList(const std::vector<WifiNetwork>& networks) {
     clearScreen();
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     // Header Title
     lv_obj_t* title = lv_label_create(current_screen);
+    ui_network_title = title;
 
     char buf[32];
     sprintf(buf, "%d Networks found", networks.size());
     lv_label_set_text(title, buf);
-    lv_obj_set_style_text_color(title, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_text_font(title, &font_gotham_medium_60, 0);
+    lv_obj_add_style(title, &style_text_title, 0);
     lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 30);
 
-    // Create a scrolling container for the list
-    lv_obj_t* list_cont = lv_obj_create(current_screen);
-    lv_obj_set_size(list_cont, 800, 350);
-    lv_obj_align(list_cont, LV_ALIGN_BOTTOM_MID, 0, 0);
-    lv_obj_set_flex_flow(list_cont, LV_FLEX_FLOW_COLUMN); // Stack cards vertically
-    lv_obj_set_style_bg_opa(list_cont, 0, 0);
-    lv_obj_set_style_border_width(list_cont, 0, 0);
-    lv_obj_set_style_pad_gap(list_cont, 10, 0); // Space between cards
-
-    // Network list
-    populateWifiList(list_cont, networks);
-
-    // Container for the "Manual Connect" footer
-    lv_obj_t* footer_cont = lv_obj_create(list_cont);
-    lv_obj_set_size(footer_cont, LV_PCT(100), LV_SIZE_CONTENT);
-    lv_obj_set_flex_flow(footer_cont, LV_FLEX_FLOW_ROW);
-    lv_obj_set_flex_align(footer_cont, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_style_bg_opa(footer_cont, 0, 0);
-    lv_obj_set_style_border_width(footer_cont, 0, 0);
-    lv_obj_set_style_pad_gap(footer_cont, 5, 0);
-
-    // "Can't see your network?" (White)
-    lv_obj_t* hint_text = lv_label_create(footer_cont);
-    lv_label_set_text(hint_text, "Can't see your network?");
-    lv_obj_set_style_text_color(hint_text, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_text_font(hint_text, &font_gotham_medium_20, 0);
+    // Virtualised list - only enough cards to fill the screen are ever created
+    network_list.create(current_screen, 800, 350, NETWORK_ROW_HEIGHT, 10,
+        [](lv_obj_t* parent, void* user_data) {
+            return getInstance().createNetworkItem(parent, "");
+        },
+        [](lv_obj_t* row, size_t index, void* user_data) {
+            const std::vector<WifiNetwork>& networks = getInstance().ui_networks;
+            lv_obj_t* label = lv_obj_get_child(row, 0);
+            lv_label_set_text(label, index < networks.size() ? networks[index].ssid.c_str() : "");
+        },
+        nullptr);
+    lv_obj_align(network_list.getContainer(), LV_ALIGN_BOTTOM_MID, 0, 0);
+
+    // Footer goes after the last row, with the same 40px gap the spacer used to give
+    network_list.setFooter(createManualConnectFooter(network_list.getContainer()), 40);
+    network_list.setCount(networks.size());
+
+    bind(FIELD_SCAN_RESULTS, &UIManager::applyScanResults, true, true);
+}
 
-    // "Connect Manually" (Green & Clickable)
-    lv_obj_t* manual_btn = lv_label_create(footer_cont);
-    lv_label_set_text(manual_btn, "Connect Manually");
-    lv_obj_set_style_text_color(manual_btn, SPOTIFY_GREEN, 0);
-    lv_obj_set_style_text_font(manual_btn, &font_gotham_medium_20, 0);
-    lv_obj_add_flag(manual_btn, LV_OBJ_FLAG_CLICKABLE);
+void UIManager::refreshNetworkList() {
+    ui_scan_version = WifiManager::getInstance().getNetworks(ui_networks);
 
-    // Click Event
-    lv_obj_add_event_cb(manual_btn, [](lv_event_t* e) {
-        getInstance().showManualConnection();
-    }, LV_EVENT_CLICKED, NULL);
+    char buf[32];
+    sprintf(buf, "%d Networks found", ui_networks.size());
+    lv_label_set_text(ui_network_title, buf);
 
+    // Visible rows are rebound in place, scroll position is untouched
+    network_list.setCount(ui_networks.size());
 }
 
 void UIManager::showWifiError() {
     clearScreen();
 
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     // Header Title
     lv_obj_t* title = lv_label_create(current_screen);
     lv_label_set_text(title, "Oops! No network found");
-    lv_obj_set_style_text_color(title, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_text_font(title, &font_gotham_medium_60, 0);
+    lv_obj_add_style(title, &style_text_title, 0);
     lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 30);
 
     // Message
     lv_obj_t * body = lv_label_create(current_screen);
     lv_label_set_text(body, "You don't appear to be\nconnected to the internet\n\nPlease check your connection\nand try again");
-    lv_obj_set_style_text_color(body, SPOTIFY_GREY, 0);
-    lv_obj_set_style_text_font(body, &font_gotham_medium_40, 0);
+    lv_obj_add_style(body, &style_text_body, 0);
     lv_obj_align(body, LV_ALIGN_TOP_LEFT, 30, 115);
 
     // Retry Button
@@ -540,13 +695,12 @@ void UIManager::showWifiError() {
 
 void UIManager::showPasswordEntry(const String &ssid) {
     clearScreen();
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     // Header
     lv_obj_t* title = lv_label_create(current_screen);
     lv_label_set_text_fmt(title, "Connect to %s", &ssid);
-    lv_obj_set_style_text_font(title, &font_gotham_medium_40, 0);
-    lv_obj_set_style_text_color(title, SPOTIFY_WHITE, 0);
+    lv_obj_add_style(title, &style_text_heading, 0);
     lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 40);
 
     // Text Area
@@ -556,12 +710,7 @@ void UIManager::showPasswordEntry(const String &ssid) {
     lv_textarea_set_placeholder_text(ta, "Enter Password");
     lv_obj_set_size(ta, 500, 60);
     lv_obj_align(ta, LV_ALIGN_TOP_MID, 0, 100);
-    lv_obj_set_style_text_font(ta, &font_gotham_medium_20, 0);
-
-    // Spotify Style
-    lv_obj_set_style_bg_color(ta, lv_color_hex(0x333333), 0);
-    lv_obj_set_style_text_color(ta, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_border_width(ta, 0, 0);
+    lv_obj_add_style(ta, &style_textarea, 0);
 
     // Keyboard
     lv_obj_t* kb = lv_keyboard_create(current_screen);
@@ -570,8 +719,8 @@ void UIManager::showPasswordEntry(const String &ssid) {
 
     lv_keyboard_set_textarea(kb, ta);
 
-    lv_obj_set_style_bg_color(kb, BACKGROUND_GREY, 0);
-    lv_obj_set_style_bg_color(kb, SPOTIFY_GREEN, LV_PART_ITEMS | LV_STATE_CHECKED);
+    lv_obj_add_style(kb, &style_keyboard, 0);
+    lv_obj_add_style(kb, &style_keyboard_checked, LV_PART_ITEMS | LV_STATE_CHECKED);
 
     // Keyboard Callback
     lv_obj_add_event_cb(kb, [](lv_event_t* e) {
@@ -584,7 +733,7 @@ void UIManager::showPasswordEntry(const String &ssid) {
 
             networkState.selected_pass = pwd;
 
-            networkState.status = WIFI_CONNECTING;
+            Lifecycle::getInstance().setWifi(WIFI_CONNECTING, "password entered");
             WifiManager::getInstance().requestConnect();
 
         } else if(code == LV_EVENT_CANCEL) {
@@ -597,29 +746,20 @@ void UIManager::showPasswordEntry(const String &ssid) {
 
 void UIManager::showManualConnection() {
     clearScreen();
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     // Keyboard Helper
     lv_obj_t* kb = lv_keyboard_create(current_screen);
     lv_obj_set_size(kb, 800, 240);
     lv_obj_align(kb, LV_ALIGN_BOTTOM_MID, 0, 0);
-    lv_obj_set_style_bg_color(kb, BACKGROUND_GREY, 0);
-    lv_obj_set_style_bg_color(kb, SPOTIFY_GREEN, LV_PART_ITEMS | LV_STATE_CHECKED);
-
-    // Text Area Style
-    static lv_style_t style_ta;
-    lv_style_init(&style_ta);
-    lv_style_set_bg_color(&style_ta, lv_color_hex(0x333333));
-    lv_style_set_text_color(&style_ta, SPOTIFY_WHITE);
-    lv_style_set_border_width(&style_ta, 0);
-    lv_style_set_text_font(&style_ta, &font_gotham_medium_20);
+    lv_obj_add_style(kb, &style_keyboard, 0);
+    lv_obj_add_style(kb, &style_keyboard_checked, LV_PART_ITEMS | LV_STATE_CHECKED);
 
 
     // Header
     lv_obj_t* title = lv_label_create(current_screen);
     lv_label_set_text_fmt(title, "Manually Connect");
-    lv_obj_set_style_text_font(title, &font_gotham_medium_40, 0);
-    lv_obj_set_style_text_color(title, SPOTIFY_WHITE, 0);
+    lv_obj_add_style(title, &style_text_heading, 0);
     lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 40);
 
     // SSID Text Area
@@ -628,7 +768,7 @@ void UIManager::showManualConnection() {
     lv_textarea_set_placeholder_text(ta_ssid, "Enter SSID");
     lv_obj_set_size(ta_ssid, 500, 60);
     lv_obj_align(ta_ssid, LV_ALIGN_TOP_MID, 0, 100);
-    lv_obj_add_style(ta_ssid, &style_ta, 0);
+    lv_obj_add_style(ta_ssid, &style_textarea, 0);
 
     // --- Password Text Area ---
     lv_obj_t* ta_pass = lv_textarea_create(current_screen);
@@ -637,7 +777,7 @@ void UIManager::showManualConnection() {
     lv_textarea_set_placeholder_text(ta_pass, "Enter Password");
     lv_obj_set_size(ta_pass, 500, 60);
     lv_obj_align(ta_pass, LV_ALIGN_TOP_MID, 0, 170);
-    lv_obj_add_style(ta_pass, &style_ta, 0);
+    lv_obj_add_style(ta_pass, &style_textarea, 0);
 
     // Default focus
     lv_keyboard_set_textarea(kb, ta_ssid);
@@ -671,7 +811,7 @@ void UIManager::showManualConnection() {
             networkState.selected_ssid = ssid_val;
             networkState.selected_pass = pass_val;
 
-            networkState.status = WIFI_CONNECTING;
+            Lifecycle::getInstance().setWifi(WIFI_CONNECTING, "manual details entered");
             WifiManager::getInstance().requestConnect();
         } else if(code == LV_EVENT_CANCEL) {
             getInstance().showOnboarding();
@@ -684,20 +824,18 @@ void UIManager::showManualConnection() {
 void UIManager::showSpotifyLinkError() {
     clearScreen();
 
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     // Header Title
     lv_obj_t* title = lv_label_create(current_screen);
     lv_label_set_text(title, "Can't connect to Spotify");
-    lv_obj_set_style_text_color(title, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_text_font(title, &font_gotham_medium_60, 0);
+    lv_obj_add_style(title, &style_text_title, 0);
     lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 30);
 
     // Message
     lv_obj_t * body = lv_label_create(current_screen);
     lv_label_set_text(body, "Something has gone wrong! \nPress the button below and follow the instructions to re-link your Spotify account");
-    lv_obj_set_style_text_color(body, SPOTIFY_GREY, 0);
-    lv_obj_set_style_text_font(body, &font_gotham_medium_40, 0);
+    lv_obj_add_style(body, &style_text_body, 0);
     lv_obj_align(body, LV_ALIGN_TOP_LEFT, 30, 115);
 
     spotify_link_error_btn_ptr = createSpotifyBtn(current_screen, errorEventHandler, "Re-link", LV_ALIGN_BOTTOM_MID, 0, -32, true);
@@ -706,20 +844,18 @@ void UIManager::showSpotifyLinkError() {
 void UIManager::showSpotifyLinking(const char *auth_url) {
     clearScreen();
 
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     // Header Title
     lv_obj_t* title = lv_label_create(current_screen);
     lv_label_set_text(title, "Link with Spotify");
-    lv_obj_set_style_text_color(title, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_text_font(title, &font_gotham_medium_60, 0);
+    lv_obj_add_style(title, &style_text_title, 0);
     lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 30);
 
     // Message
     lv_obj_t * body = lv_label_create(current_screen);
     lv_label_set_text(body, "Scan the QR code and follow the \ninstructions to link your Spotify!");
-    lv_obj_set_style_text_color(body, SPOTIFY_GREY, 0);
-    lv_obj_set_style_text_font(body, &font_gotham_medium_40, 0);
+    lv_obj_add_style(body, &style_text_body, 0);
     lv_obj_align(body, LV_ALIGN_TOP_LEFT, 30, 115);
 
     // QR Code
@@ -731,20 +867,18 @@ void UIManager::showSpotifyLinking(const char *auth_url) {
 void UIManager::showSpotifyError() {
     clearScreen();
 
-    lv_obj_set_style_bg_color(current_screen, BACKGROUND_GREY, 0);
+    lv_obj_add_style(current_screen, &style_screen, 0);
 
     // Header Title
     lv_obj_t* title = lv_label_create(current_screen);
     lv_label_set_text(title, "Spotify Failed to Connect");
-    lv_obj_set_style_text_color(title, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_text_font(title, &font_gotham_medium_60, 0);
+    lv_obj_add_style(title, &style_text_title, 0);
     lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 30);
 
     // Message
     lv_obj_t * body = lv_label_create(current_screen);
     lv_label_set_text(body, "A failure occurred when trying to \nauthorise Spotify. \nPlease try again. If the issue \npersists try re-linking!");
-    lv_obj_set_style_text_color(body, SPOTIFY_GREY, 0);
-    lv_obj_set_style_text_font(body, &font_gotham_medium_40, 0);
+    lv_obj_add_style(body, &style_text_body, 0);
     lv_obj_align(body, LV_ALIGN_TOP_LEFT, 30, 115);
 
     // Retry Button
@@ -763,7 +897,6 @@ void UIManager::showMainPlayer() {
 
     // Background
     lv_obj_set_style_bg_color(current_screen, lv_color_hex(spotifyState.album_background_cover), 0);
-    lv_obj_set_style_bg_opa(current_screen, LV_OPA_COVER, 0);
     lv_obj_clear_flag(current_screen, LV_OBJ_FLAG_SCROLLABLE);
 
     // Album Art
@@ -771,23 +904,16 @@ void UIManager::showMainPlayer() {
     lv_img_set_src(ui_album_art, &album_dsc);
     lv_obj_set_size(ui_album_art, 365, 365);
     lv_obj_align(ui_album_art, LV_ALIGN_LEFT_MID, 25, -10);
-    lv_obj_set_style_radius(ui_album_art, 15, 0);
-    lv_obj_set_style_clip_corner(ui_album_art, true, 0);
     lv_obj_add_flag(ui_album_art, LV_OBJ_FLAG_IGNORE_LAYOUT | LV_OBJ_FLAG_FLOATING);
-
-    // Album Art - Inner Border
-    lv_obj_set_style_border_width(ui_album_art, 1, 0);
-    lv_obj_set_style_border_color(ui_album_art, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_border_opa(ui_album_art, LV_OPA_10, 0);
+    // Rounded corners and inner border are baked into the pixels by ArtFrame
 
 
     // Info Container
     lv_obj_t* info_con = lv_obj_create(current_screen);
     lv_obj_set_size(info_con, 375, 365);
     lv_obj_align(info_con, LV_ALIGN_RIGHT_MID, -20, -10);
-    lv_obj_set_style_bg_opa(info_con, 0, 0);
-    lv_obj_set_style_border_width(info_con, 0, 0);
-    lv_obj_set_style_pad_all(info_con, 0, 0);
+    lv_obj_add_style(info_con, &style_panel, 0);
+    lv_obj_add_style(info_con, &style_flush, 0);
     lv_obj_clear_flag(info_con, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_add_flag(info_con, LV_OBJ_FLAG_IGNORE_LAYOUT | LV_OBJ_FLAG_FLOATING);
 
@@ -797,8 +923,7 @@ void UIManager::showMainPlayer() {
     lv_obj_set_width(ui_song_artist, 370);
     lv_obj_align(ui_song_artist, LV_ALIGN_BOTTOM_LEFT, 0, 0);
     lv_label_set_text(ui_song_artist, spotifyState.current_track_artist.c_str());
-    lv_obj_set_style_text_font(ui_song_artist, &font_gotham_medium_30, 0);
-    lv_obj_set_style_text_color(ui_song_artist, lv_color_hex(0xBBBBBB), 0);
+    lv_obj_add_style(ui_song_artist, &style_text_artist, 0);
     lv_label_set_long_mode(ui_song_artist, LV_LABEL_LONG_DOT);
 
     // Song Title
@@ -807,28 +932,23 @@ void UIManager::showMainPlayer() {
     lv_obj_set_height(ui_song_title, 110);
     lv_obj_align_to(ui_song_title, ui_song_artist, LV_ALIGN_OUT_TOP_LEFT, 0, -5);
     lv_label_set_text(ui_song_title, spotifyState.current_track_title.c_str());
-    lv_obj_set_style_text_font(ui_song_title, &font_metropolis_black_45, 0);
-    lv_obj_set_style_text_color(ui_song_title, SPOTIFY_WHITE, 0);
+    lv_obj_add_style(ui_song_title, &style_text_track, 0);
     lv_label_set_long_mode(ui_song_title, LV_LABEL_LONG_DOT);
     //lv_label_set_long_mode(ui_song_title, LV_LABEL_LONG_SCROLL_CIRCULAR);
     //lv_obj_set_style_anim_speed(ui_song_title, 30, 0);
     lv_obj_add_flag(ui_song_title, LV_OBJ_FLAG_FLOATING);
-    lv_obj_set_style_text_opa(ui_song_title, LV_OPA_COVER, 0);
-    lv_obj_set_style_blend_mode(ui_song_title, LV_BLEND_MODE_NORMAL, 0);
 
 
     // Device Info
     lv_obj_t* device_con = lv_obj_create(info_con);
     lv_obj_set_size(device_con, 370, 40);
     lv_obj_align_to(device_con, ui_song_title, LV_ALIGN_OUT_TOP_LEFT, 0, -5);
-    lv_obj_set_style_bg_opa(device_con, 0, 0);
-    lv_obj_set_style_border_width(device_con, 0, 0);
-    lv_obj_set_style_pad_all(device_con, 0, 0);
+    lv_obj_add_style(device_con, &style_panel, 0);
+    lv_obj_add_style(device_con, &style_flush, 0);
     lv_obj_add_flag(device_con, LV_OBJ_FLAG_IGNORE_LAYOUT);
 
     // Only use flex for this tiny, static sub-container
-    lv_obj_set_flex_flow(device_con, LV_FLEX_FLOW_ROW);
-    lv_obj_set_flex_align(device_con, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_add_style(device_con, &style_row, 0);
 
     lv_obj_t* icon = lv_img_create(device_con);
     lv_img_set_src(icon, &CurrentDeviceLogo);
@@ -836,28 +956,36 @@ void UIManager::showMainPlayer() {
 
     ui_device_name = lv_label_create(device_con);
     lv_label_set_text(ui_device_name, spotifyState.current_track_device_name.c_str());
-    lv_obj_set_style_text_font(ui_device_name, &font_gotham_medium_20, 0);
-    lv_obj_set_style_text_color(ui_device_name, SPOTIFY_WHITE, 0);
+    lv_obj_add_style(ui_device_name, &style_text_caption, 0);
     lv_obj_set_width(ui_device_name, 280);
     lv_label_set_long_mode(ui_device_name, LV_LABEL_LONG_DOT);
 
+    // Link Status - only shown while the WiFi link is being re-established
+    ui_link_status = lv_label_create(current_screen);
+    lv_label_set_text(ui_link_status, "Reconnecting...");
+    lv_obj_add_style(ui_link_status, &style_text_status, 0);
+    lv_obj_align(ui_link_status, LV_ALIGN_TOP_RIGHT, -20, 12);
+    if (!networkState.link_lost) lv_obj_add_flag(ui_link_status, LV_OBJ_FLAG_HIDDEN);
+
     // Progress Bar
     ui_progress_bar = lv_bar_create(current_screen);
     lv_obj_set_size(ui_progress_bar, 800, 10);
     lv_obj_align(ui_progress_bar, LV_ALIGN_BOTTOM_MID, 0, 0);
-    lv_obj_set_style_bg_color(ui_progress_bar, lv_color_hex(0x333333), LV_PART_MAIN);
-    lv_obj_set_style_bg_color(ui_progress_bar, SPOTIFY_WHITE, LV_PART_INDICATOR);
-    lv_obj_set_style_radius(ui_progress_bar, 0, 0);
-    lv_obj_set_style_bg_opa(ui_progress_bar, LV_OPA_COVER, LV_PART_INDICATOR);
-    lv_obj_set_style_bg_opa(ui_progress_bar, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_add_style(ui_progress_bar, &style_progress, LV_PART_MAIN);
+    lv_obj_add_style(ui_progress_bar, &style_progress_indicator, LV_PART_INDICATOR);
 
     // Load Image
-    if (!spotifyState.current_track_url.isEmpty()) {
-        SpotifyManager::getInstance().loadAlbumArt(spotifyState.current_track_url, 365);
-    } else {
-        String np_url = "https://raw.githubusercontent.com/Harry-Skerritt/files/refs/heads/main/not_playing_album.jpg";
-        SpotifyManager::getInstance().loadAlbumArt(np_url, 365);
-    }
+    requestArt(365);
+    resetMarquee(ui_song_title);
+    resetMarquee(ui_song_artist);
+
+    // Built from the current state above, these pick up what changes after
+    bind(FIELD_TRACK_TEXT, &UIManager::applyTrackText, true);
+    bind(FIELD_TRACK_ART, &UIManager::applyTrackArt, true);
+    bind(FIELD_ART_READY, &UIManager::applyArtReady, true, true);
+    bind(FIELD_BACKGROUND, &UIManager::applyBackground, true);
+    bind(FIELD_DEVICE_NAME, &UIManager::applyDeviceName, true);
+    bind(FIELD_LINK_LOST, &UIManager::applyLinkStatus, true);
 
 
 
@@ -991,10 +1119,10 @@ void UIManager::showMainPlayer() {
 
     // Load Image
     if (!spotifyState.current_track_url.isEmpty()) {
-        SpotifyManager::getInstance().loadAlbumArt(spotifyState.current_track_url, 365);
+        SpotifyManager::getInstance().requestAlbumArt(spotifyState.current_track_url, 365);
     } else {
         String np_url = "https://raw.githubusercontent.com/Harry-Skerritt/files/refs/heads/main/not_playing_album.jpg";
-        SpotifyManager::getInstance().loadAlbumArt(np_url, 365);
+        SpotifyManager::getInstance().requestAlbumArt(np_url, 365);
     }
     resetMarquee(ui_song_title);
     */
@@ -1048,16 +1176,163 @@ void UIManager::initStyles() {
     lv_style_set_bg_color(&style_network_card, lv_color_hex(0x444444));
     lv_style_set_bg_opa(&style_network_card, LV_OPA_COVER);
     lv_style_set_radius(&style_network_card, 12);
-    lv_style_set_pad_all(&style_network_card, 15);
+    lv_style_set_pad_ver(&style_network_card, 10);
+    lv_style_set_pad_hor(&style_network_card, 20);
     lv_style_set_width(&style_network_card, 750); // Standard width for 800px screen
-    lv_style_set_height(&style_network_card, LV_SIZE_CONTENT);
+    lv_style_set_height(&style_network_card, NETWORK_ROW_HEIGHT); // Fixed so the virtual list can position rows
+    lv_style_set_layout(&style_network_card, LV_LAYOUT_FLEX);
+    lv_style_set_flex_flow(&style_network_card, LV_FLEX_FLOW_ROW);
+    lv_style_set_flex_main_place(&style_network_card, LV_FLEX_ALIGN_SPACE_BETWEEN);
+    lv_style_set_flex_cross_place(&style_network_card, LV_FLEX_ALIGN_CENTER);
+    lv_style_set_flex_track_place(&style_network_card, LV_FLEX_ALIGN_CENTER);
+
+    // --- Containers ---
+    lv_style_init(&style_screen);
+    lv_style_set_bg_color(&style_screen, BACKGROUND_GREY);
+
+    lv_style_init(&style_panel);
+    lv_style_set_bg_opa(&style_panel, LV_OPA_TRANSP);
+    lv_style_set_border_width(&style_panel, 0);
+    lv_style_set_shadow_width(&style_panel, 0);
+
+    lv_style_init(&style_flush);
+    lv_style_set_pad_all(&style_flush, 0);
+
+    lv_style_init(&style_row);
+    lv_style_set_layout(&style_row, LV_LAYOUT_FLEX);
+    lv_style_set_flex_flow(&style_row, LV_FLEX_FLOW_ROW);
+    lv_style_set_flex_cross_place(&style_row, LV_FLEX_ALIGN_CENTER);
+    lv_style_set_flex_track_place(&style_row, LV_FLEX_ALIGN_CENTER);
+
+    lv_style_init(&style_footer);
+    lv_style_set_flex_main_place(&style_footer, LV_FLEX_ALIGN_CENTER);
+    lv_style_set_pad_row(&style_footer, 5);
+    lv_style_set_pad_column(&style_footer, 5);
+
+    lv_style_init(&style_logo);
+    lv_style_set_pad_column(&style_logo, 0);
+    lv_style_set_text_color(&style_logo, SPOTIFY_WHITE);
+    lv_style_set_text_font(&style_logo, &font_gotham_medium_80);
+
+    // --- Text ---
+    lv_style_init(&style_text_title);
+    lv_style_set_text_color(&style_text_title, SPOTIFY_WHITE);
+    lv_style_set_text_font(&style_text_title, &font_gotham_medium_60);
+
+    lv_style_init(&style_text_body);
+    lv_style_set_text_color(&style_text_body, SPOTIFY_GREY);
+    lv_style_set_text_font(&style_text_body, &font_gotham_medium_40);
+
+    lv_style_init(&style_text_heading);
+    lv_style_set_text_color(&style_text_heading, SPOTIFY_WHITE);
+    lv_style_set_text_font(&style_text_heading, &font_gotham_medium_40);
+
+    lv_style_init(&style_text_caption);
+    lv_style_set_text_color(&style_text_caption, SPOTIFY_WHITE);
+    lv_style_set_text_font(&style_text_caption, &font_gotham_medium_20);
+
+    lv_style_init(&style_text_status);
+    lv_style_set_text_color(&style_text_status, SPOTIFY_GREY);
+    lv_style_set_text_font(&style_text_status, &font_gotham_medium_20);
+
+    lv_style_init(&style_text_green);
+    lv_style_set_text_color(&style_text_green, SPOTIFY_GREEN);
+
+    lv_style_init(&style_text_track);
+    lv_style_set_text_color(&style_text_track, SPOTIFY_WHITE);
+    lv_style_set_text_font(&style_text_track, &font_metropolis_black_45);
+
+    lv_style_init(&style_text_artist);
+    lv_style_set_text_color(&style_text_artist, lv_color_hex(0xBBBBBB));
+    lv_style_set_text_font(&style_text_artist, &font_gotham_medium_30);
+
+    // --- Buttons ---
+    lv_style_init(&style_btn_label);
+    lv_style_set_text_font(&style_btn_label, &font_gotham_medium_40);
+
+    lv_style_init(&style_btn_green_pressed);
+    lv_style_set_bg_color(&style_btn_green_pressed, SPOTIFY_GREEN);
+
+    lv_style_init(&style_btn_outline_pressed);
+    lv_style_set_bg_color(&style_btn_outline_pressed, SPOTIFY_GREEN_DARKER);
+    lv_style_set_bg_opa(&style_btn_outline_pressed, LV_OPA_30);
+
+    lv_style_init(&style_btn_small);
+    lv_style_set_width(&style_btn_small, 170);
+    lv_style_set_height(&style_btn_small, 42);
+    lv_style_set_radius(&style_btn_small, 20);
+
+    // --- Widgets ---
+    lv_style_init(&style_textarea);
+    lv_style_set_bg_color(&style_textarea, lv_color_hex(0x333333));
+    lv_style_set_text_color(&style_textarea, SPOTIFY_WHITE);
+    lv_style_set_border_width(&style_textarea, 0);
+    lv_style_set_text_font(&style_textarea, &font_gotham_medium_20);
+
+    lv_style_init(&style_keyboard);
+    lv_style_set_bg_color(&style_keyboard, BACKGROUND_GREY);
+
+    lv_style_init(&style_keyboard_checked);
+    lv_style_set_bg_color(&style_keyboard_checked, SPOTIFY_GREEN);
+
+    lv_style_init(&style_spinner);
+    lv_style_set_arc_width(&style_spinner, 8);
+
+    lv_style_init(&style_spinner_indicator);
+    lv_style_set_arc_width(&style_spinner_indicator, 8);
+    lv_style_set_arc_color(&style_spinner_indicator, SPOTIFY_GREEN);
+
+    lv_style_init(&style_progress);
+    lv_style_set_bg_color(&style_progress, lv_color_hex(0x333333));
+    lv_style_set_bg_opa(&style_progress, LV_OPA_COVER);
+    lv_style_set_radius(&style_progress, 0);
+
+    lv_style_init(&style_progress_indicator);
+    lv_style_set_bg_color(&style_progress_indicator, SPOTIFY_WHITE);
+    lv_style_set_bg_opa(&style_progress_indicator, LV_OPA_COVER);
+
+    lv_style_init(&style_qr_frame);
+    lv_style_set_radius(&style_qr_frame, 15);
+    lv_style_set_bg_color(&style_qr_frame, lv_color_hex(0x121212));
+    lv_style_set_border_color(&style_qr_frame, SPOTIFY_GREEN);
+    lv_style_set_border_width(&style_qr_frame, 2);
+    lv_style_set_clip_corner(&style_qr_frame, true);
+    lv_style_set_pad_all(&style_qr_frame, 5);
+}
+
+// Objects and local style properties under obj
+static void countScreen(lv_obj_t* obj, uint32_t& objects, uint32_t& local_props) {
+    objects++;
+    for (uint32_t i = 0; i < obj->style_cnt; i++) {
+        if (obj->styles[i].is_local) local_props += obj->styles[i].style->prop_cnt;
+    }
+    for (uint32_t i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+        countScreen(lv_obj_get_child(obj, i), objects, local_props);
+    }
+}
+
+void UIManager::logScreenCost(lv_obj_t* screen) {
+    uint32_t objects = 0;
+    uint32_t local_props = 0;
+    countScreen(screen, objects, local_props);
+
+    // LV_MEM_CUSTOM routes LVGL through malloc, so the heap shows what the screen took
+    uint32_t free_now = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TRACE(TRACE_UI_SCREEN_COST, (objects << 16) | (local_props & 0xFFFF), screen_heap_free - free_now);
+    screen_heap_free = 0;
 }
 
 void UIManager::clearScreen() {
+    unbindScreen();
+    network_list.reset();
+    ui_network_title = nullptr;
     ui_album_art = nullptr;
+    ui_link_status = nullptr;
     ui_song_title = nullptr;
     ui_song_artist = nullptr;
     ui_device_name = nullptr;
+    title_layer.detach();
+    artist_layer.detach();
     lv_obj_t* old_scr = lv_scr_act();
     current_screen = lv_obj_create(NULL);
 
@@ -1065,6 +1340,9 @@ void UIManager::clearScreen() {
         lv_scr_load(current_screen);
         if(old_scr) lv_obj_del_async(old_scr);
     }
+
+    // Baseline for the new screen, logged once update() has built it
+    screen_heap_free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
 }
 
 // Button Helper
@@ -1078,11 +1356,10 @@ lv_obj_t* UIManager::createSpotifyBtn(lv_obj_t* parent, const lv_event_cb_t cb,
 
     if (is_green) {
         lv_obj_add_style(btn, &style_btn_green, 0);
-        lv_obj_set_style_bg_color(btn, SPOTIFY_GREEN, LV_STATE_PRESSED);
+        lv_obj_add_style(btn, &style_btn_green_pressed, LV_STATE_PRESSED);
     } else {
         lv_obj_add_style(btn, &style_btn_outline, 0);
-        lv_obj_set_style_bg_color(btn, SPOTIFY_GREEN_DARKER, LV_STATE_PRESSED);
-        lv_obj_set_style_bg_opa(btn, LV_OPA_30, LV_STATE_PRESSED);
+        lv_obj_add_style(btn, &style_btn_outline_pressed, LV_STATE_PRESSED);
     }
 
     // Label
@@ -1090,7 +1367,7 @@ lv_obj_t* UIManager::createSpotifyBtn(lv_obj_t* parent, const lv_event_cb_t cb,
 
     lv_obj_t* label = lv_label_create(btn);
     lv_label_set_text(label, text);
-    lv_obj_set_style_text_font(label, &font_gotham_medium_40, 0);
+    lv_obj_add_style(label, &style_btn_label, 0);
     lv_obj_center(label);
 
     lv_obj_add_event_cb(btn, cb, LV_EVENT_ALL, NULL);
@@ -1104,25 +1381,22 @@ lv_obj_t *UIManager::createLogo(lv_obj_t *parent, const lv_font_t *font, const l
     lv_obj_set_size(cont, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
 
     // Flex Container
-    lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_ROW);
-    lv_obj_set_style_pad_column(cont, 0, 0); // This makes words touch
-    lv_obj_set_style_pad_all(cont, 0, 0);
-    lv_obj_set_style_bg_opa(cont, 0, 0);
-    lv_obj_set_style_border_width(cont, 0, 0);
-
-    lv_obj_set_style_flex_cross_place(cont, LV_FLEX_ALIGN_CENTER, 0);
+    lv_obj_add_style(cont, &style_panel, 0);
+    lv_obj_add_style(cont, &style_flush, 0);
+    lv_obj_add_style(cont, &style_row, 0);
+    lv_obj_add_style(cont, &style_logo, 0);  // No gap - this makes words touch
 
     // Spotify
     lv_obj_t* l1 = lv_label_create(cont);
     lv_label_set_text(l1, "Spotify");
-    lv_obj_set_style_text_color(l1, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_text_font(l1, font, 0);
 
     // Mate
     lv_obj_t* l2 = lv_label_create(cont);
     lv_label_set_text(l2, "Mate");
-    lv_obj_set_style_text_color(l2, SPOTIFY_GREEN, 0);
-    lv_obj_set_style_text_font(l2, font, 0);
+    lv_obj_add_style(l2, &style_text_green, 0);
+
+    // Logo style has the usual font, anything else is set on the container and inherited
+    if (font != &font_gotham_medium_80) lv_obj_set_style_text_font(cont, font, 0);
 
     lv_obj_align(cont, align, x, y);
 
@@ -1132,21 +1406,12 @@ lv_obj_t *UIManager::createLogo(lv_obj_t *parent, const lv_font_t *font, const l
 lv_obj_t *UIManager::createNetworkItem(lv_obj_t *parent, const char *ssid) {
     lv_obj_t* card = lv_obj_create(parent);
     lv_obj_add_style(card, &style_network_card, 0);
-
-    lv_obj_set_flex_flow(card, LV_FLEX_FLOW_ROW);
-    lv_obj_set_flex_align(card, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-
-    // Padding
-    lv_obj_set_style_pad_top(card, 10, 0);
-    lv_obj_set_style_pad_bottom(card, 10, 0);
-    lv_obj_set_style_pad_left(card, 20, 0);
-    lv_obj_set_style_pad_right(card, 20, 0);
+    lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
 
     // SSID (Left)
     lv_obj_t* label = lv_label_create(card);
     lv_label_set_text(label, ssid);
-    lv_obj_set_style_text_color(label, SPOTIFY_WHITE, 0);
-    lv_obj_set_style_text_font(label, &font_gotham_medium_40, 0);
+    lv_obj_add_style(label, &style_text_heading, 0);
 
     // Truncation
     lv_obj_set_flex_grow(label, 1);
@@ -1155,15 +1420,13 @@ lv_obj_t *UIManager::createNetworkItem(lv_obj_t *parent, const char *ssid) {
 
     // Connect Button (Right)
     lv_obj_t* btn = lv_btn_create(card);
-    lv_obj_set_size(btn, 170, 42);
     lv_obj_add_style(btn, &style_btn_green, 0); // Reuse your green style
-    lv_obj_set_style_radius(btn, 20, 0);
+    lv_obj_add_style(btn, &style_btn_small, 0);
     lv_obj_add_event_cb(btn, wifiJoinEventHandler, LV_EVENT_CLICKED, NULL);
 
     lv_obj_t* btn_label = lv_label_create(btn);
     lv_label_set_text(btn_label, "Connect");
-    lv_obj_set_style_text_font(btn_label, &font_gotham_medium_20, 0);
-    lv_obj_set_style_text_color(btn_label, SPOTIFY_WHITE, 0);
+    lv_obj_add_style(btn_label, &style_text_caption, 0);
     lv_obj_center(btn_label);
 
     return card;
@@ -1172,78 +1435,90 @@ lv_obj_t *UIManager::createNetworkItem(lv_obj_t *parent, const char *ssid) {
 lv_obj_t *UIManager::createCustomQRCode(lv_obj_t *parent, const char *url, int size) {
     lv_obj_t* frame = lv_obj_create(parent);
     lv_obj_set_size(frame, size + 10, size + 10);
-    lv_obj_set_style_radius(frame, 15, 0);
-    lv_obj_set_style_bg_color(frame, lv_color_hex(0x121212), 0);
-    lv_obj_set_style_border_color(frame, SPOTIFY_GREEN, 0);
-    lv_obj_set_style_border_width(frame, 2, 0);
-    lv_obj_set_style_clip_corner(frame, true, 0);
-    lv_obj_set_style_pad_all(frame, 5, 0);
+    lv_obj_add_style(frame, &style_qr_frame, 0);
     lv_obj_clear_flag(frame, LV_OBJ_FLAG_SCROLLABLE);
 
 
-    lv_obj_t* qr = lv_qrcode_create(frame, size, SPOTIFY_GREEN, lv_color_hex(0x121212));
-    lv_qrcode_update(qr, url, strlen(url));
+    // Encoding is the slow part - keep a snapshot of the code and reuse it while the URL is the same
+    bool cached = qr_cache.data && qr_cache_url == url && qr_cache.header.w == size;
 
-    lv_obj_align(qr, LV_ALIGN_CENTER, 0, 0);
-    lv_obj_add_flag(qr, LV_OBJ_FLAG_IGNORE_LAYOUT);
+    if (!cached) {
+        lv_obj_t* qr = lv_qrcode_create(frame, size, SPOTIFY_GREEN, lv_color_hex(0x121212));
+        lv_qrcode_update(qr, url, strlen(url));
+        lv_obj_align(qr, LV_ALIGN_CENTER, 0, 0);
+        lv_obj_add_flag(qr, LV_OBJ_FLAG_IGNORE_LAYOUT);
+        lv_obj_update_layout(qr);
 
-    return frame;
-}
+        uint32_t needed = lv_snapshot_buf_size_needed(qr, LV_IMG_CF_TRUE_COLOR);
+        if (qr_cache_buf && qr_cache_buf_size != needed) {
+            free(qr_cache_buf);
+            qr_cache_buf = nullptr;
+        }
+        if (!qr_cache_buf) {
+            qr_cache_buf = (uint8_t*)ps_malloc(needed);
+            qr_cache_buf_size = qr_cache_buf ? needed : 0;
+        }
 
-void UIManager::populateWifiList(lv_obj_t* list_cont, const std::vector<String>& networks) {
-    lv_obj_clean(list_cont);
+        if (!qr_cache_buf || lv_snapshot_take_to_buf(qr, LV_IMG_CF_TRUE_COLOR, &qr_cache, qr_cache_buf, needed) != LV_RES_OK) {
+            // No snapshot, the live code still works
+            qr_cache.data = nullptr;
+            return frame;
+        }
 
-    for (const String& ssid : networks) {
-        createNetworkItem(list_cont, ssid.c_str());
+        qr_cache_url = url;
+        lv_obj_del(qr);
     }
 
-    lv_obj_t* spacer = lv_obj_create(list_cont);
-    lv_obj_set_size(spacer, LV_PCT(100), 40);
-    lv_obj_set_style_bg_opa(spacer, 0, 0);
-    lv_obj_set_style_border_width(spacer, 0, 0);
-
-    lv_obj_scroll_to_y(list_cont, 0, LV_ANIM_OFF);
-}
+    lv_obj_t* qr_img = lv_img_create(frame);
+    lv_img_set_src(qr_img, &qr_cache);
+    lv_obj_align(qr_img, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_add_flag(qr_img, LV_OBJ_FLAG_IGNORE_LAYOUT);
 
-static void marquee_anim_cb(void* var, int32_t v) {
-    lv_obj_set_style_translate_x((lv_obj_t*) var, v, 0);
+    return frame;
 }
 
-void UIManager::resetMarquee(lv_obj_t *label) {
-    /*
-    // Stop Existing
-    lv_anim_del(label, (lv_anim_exec_xcb_t)marquee_anim_cb);
-
-    // Reset Pos
-    lv_obj_set_style_translate_x(label, 0, 0);
-    lv_label_set_long_mode(label, LV_LABEL_LONG_CLIP);
+lv_obj_t *UIManager::createManualConnectFooter(lv_obj_t *parent) {
+    // Container for the "Manual Connect" footer
+    lv_obj_t* footer_cont = lv_obj_create(parent);
+    lv_obj_set_size(footer_cont, LV_PCT(100), LV_SIZE_CONTENT);
+    lv_obj_add_style(footer_cont, &style_panel, 0);
+    lv_obj_add_style(footer_cont, &style_row, 0);
+    lv_obj_add_style(footer_cont, &style_footer, 0);
 
-    // Calc scroll
-    lv_point_t size;
-    lv_txt_get_size(&size, lv_label_get_text(label), lv_obj_get_style_text_font(label, 0),
-        0, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+    // "Can't see your network?" (White)
+    lv_obj_t* hint_text = lv_label_create(footer_cont);
+    lv_label_set_text(hint_text, "Can't see your network?");
+    lv_obj_add_style(hint_text, &style_text_caption, 0);
 
-    int32_t obj_width = lv_obj_get_width(label);
-    int32_t scroll_limit = size.x - obj_width;
+    // "Connect Manually" (Green & Clickable)
+    lv_obj_t* manual_btn = lv_label_create(footer_cont);
+    lv_label_set_text(manual_btn, "Connect Manually");
+    lv_obj_add_style(manual_btn, &style_text_caption, 0);
+    lv_obj_add_style(manual_btn, &style_text_green, 0);
+    lv_obj_add_flag(manual_btn, LV_OBJ_FLAG_CLICKABLE);
 
-    if (scroll_limit <= 0) return;
+    // Click Event
+    lv_obj_add_event_cb(manual_btn, [](lv_event_t* e) {
+        getInstance().showManualConnection();
+    }, LV_EVENT_CLICKED, NULL);
 
-    lv_anim_t a;
-    lv_anim_init(&a);
-    lv_anim_set_var(&a, label);
-    lv_anim_set_values(&a, 0, -scroll_limit - 40);
+    return footer_cont;
+}
 
-    lv_anim_set_time(&a, (size.x) * 30);
+void UIManager::resetMarquee(lv_obj_t *label) {
+    if (label == nullptr) return;
+    TextLayer& layer = (label == ui_song_artist) ? artist_layer : title_layer;
+    layer.hide();
 
-    lv_anim_set_exec_cb(&a, (lv_anim_exec_xcb_t)marquee_anim_cb);
-    lv_anim_set_path_cb(&a, lv_anim_path_linear);
+    // Calc scroll
+    const char* text = lv_label_get_text(label);
+    const lv_font_t* font = lv_obj_get_style_text_font(label, 0);
+    lv_coord_t text_w = lv_txt_get_width(text, strlen(text), font, 0, LV_TEXT_FLAG_NONE);
 
-    // Loop
-    lv_anim_set_delay(&a, 2000);
-    lv_anim_set_playback_time(&a, 0);
-    lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_set_repeat_delay(&a, 30000);
+    lv_obj_update_layout(label);
+    if (text_w <= lv_obj_get_width(label)) return;
 
-    lv_anim_start(&a);
-    */
+    // Rendered once per track, the label stays as the fallback if it won't fit in memory
+    if (!layer.render(text, font, lv_obj_get_style_text_color(label, 0))) return;
+    layer.show(label);
 }
\ No newline at end of file
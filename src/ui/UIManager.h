@@ -7,6 +7,14 @@
 
 #include <Arduino.h>
 #include <lvgl.h>
+#include <vector>
+
+#include "global_state.h"
+#include "system/StateBus.h"
+#include "VirtualList.h"
+#include "AssetStore.h"
+#include "ArtFrame.h"
+#include "TextLayer.h"
 
 
 // --- Global Colours ---
@@ -16,6 +24,8 @@
 #define SPOTIFY_WHITE lv_color_hex(0xFFFFFF)
 #define SPOTIFY_GREY lv_color_hex(0xCCCCCC)
 
+#define UI_MAX_BINDINGS 16
+
 // --- Global fonts ---
 LV_FONT_DECLARE(font_gotham_medium_20);
 LV_FONT_DECLARE(font_gotham_medium_30);
@@ -46,7 +56,7 @@ public:
 
     // WiFi Screens
     void showOnboarding();
-    void showNetworkList(const std::vector<String>& networks);
+    void showNetworkList(const std::vector<WifiNetwork>& networks);
     void showPasswordEntry(const String& ssid);
     void showWifiError();
     void showManualConnection();
@@ -61,7 +71,8 @@ public:
     void setTrackProgress(int32_t current_ms, int32_t total_ms);
 
 
-    void updateAlbumArt(uint8_t* jpgData, size_t len, short t_size);
+    void updateAlbumArt(uint8_t* jpgData, size_t len, short t_size, const String& request_url);
+    void presentAlbumArt(const lv_img_dsc_t* dsc);
 
     static lv_img_dsc_t album_dsc;
     static uint16_t* album_buffer;
@@ -74,6 +85,7 @@ public:
     lv_obj_t* ui_song_artist = nullptr;
     lv_obj_t* ui_device_name = nullptr;
     lv_obj_t* ui_progress_bar = nullptr;
+    lv_obj_t* ui_link_status = nullptr;
 
 private:
     UIManager() {}
@@ -92,15 +104,98 @@ private:
 
     lv_style_t style_network_card;
 
+    // Catalogue - built once, shared by every screen so objects don't carry their own local styles
+    lv_style_t style_screen;            // Grey background
+    lv_style_t style_panel;             // Transparent, borderless container
+    lv_style_t style_flush;             // No padding
+    lv_style_t style_row;               // Flex row, centred vertically
+    lv_style_t style_footer;            // Centred row with a small gap
+    lv_style_t style_logo;              // Logo font, words touching
+
+    lv_style_t style_text_title;        // 60 white
+    lv_style_t style_text_body;         // 40 grey
+    lv_style_t style_text_heading;      // 40 white
+    lv_style_t style_text_caption;      // 20 white
+    lv_style_t style_text_status;       // 20 grey
+    lv_style_t style_text_green;        // Colour only, font comes from another style
+    lv_style_t style_text_track;        // Player title
+    lv_style_t style_text_artist;       // Player artist
+
+    lv_style_t style_btn_label;
+    lv_style_t style_btn_green_pressed;
+    lv_style_t style_btn_outline_pressed;
+    lv_style_t style_btn_small;         // Network card connect button
+
+    lv_style_t style_textarea;
+    lv_style_t style_keyboard;
+    lv_style_t style_keyboard_checked;
+    lv_style_t style_spinner;
+    lv_style_t style_spinner_indicator;
+    lv_style_t style_progress;
+    lv_style_t style_progress_indicator;
+    lv_style_t style_qr_frame;
+
+    // Heap free when the current screen was started, 0 once its cost is logged
+    uint32_t screen_heap_free = 0;
+    void logScreenCost(lv_obj_t* screen);
+
     // Internal Helpers
     lv_obj_t* createSpotifyBtn(lv_obj_t* parent, lv_event_cb_t cb, const char* text, lv_align_t align, int x, int y, bool is_green);
     lv_obj_t* createLogo(lv_obj_t* parent, const lv_font_t* font, lv_align_t align, int x, int y);
     lv_obj_t* createNetworkItem(lv_obj_t* parent, const char* ssid);
     lv_obj_t* createCustomQRCode(lv_obj_t* parent, const char* url, int size);
 
+    // Rendered auth QR, reused across visits to the linking screen
+    lv_img_dsc_t qr_cache = {};
+    uint8_t* qr_cache_buf = nullptr;
+    uint32_t qr_cache_buf_size = 0;
+    String qr_cache_url;
+
+    // Title / artist scroll as pre-rendered layers when they don't fit
+    TextLayer title_layer;
+    TextLayer artist_layer;
     void resetMarquee(lv_obj_t* label);
 
-    void populateWifiList(lv_obj_t* list_cont, const std::vector<String>& networks);
+    // Album art
+    AssetId bake_asset = ASSET_NONE;   // Asset the decode of art_request_url should be stored as
+    String art_request_url;             // Latest art asked for, anything else that arrives is stale
+    ArtFrame art_frame;
+    void requestArt(short t_size);
+
+    // State bindings - each frame only the ones whose field was published since are applied
+    struct Binding {
+        StateField field;
+        uint32_t seen;              // Field version last applied
+        void (UIManager::*apply)();
+        bool screen;                // Dropped along with the current screen's widgets
+    };
+    Binding bindings[UI_MAX_BINDINGS];
+    int binding_count = 0;
+    uint32_t bus_seen = 0;
+    bool bindings_dirty = false;
+    uint32_t screen_generation = 0;
+    void bind(StateField field, void (UIManager::*apply)(), bool screen, bool apply_now = false);
+    void unbindScreen();
+    void applyBindings();
+
+    void applyWifiStatus();
+    void applySpotifyStatus();
+    void applyScanResults();
+    void applyTrackText();
+    void applyTrackArt();
+    void applyArtReady();
+    void applyBackground();
+    void applyDeviceName();
+    void applyLinkStatus();
+
+    lv_obj_t* createManualConnectFooter(lv_obj_t* parent);
+    void refreshNetworkList();
+
+    // Network list - kept so streamed scan results can update it in place
+    VirtualList network_list;
+    lv_obj_t* ui_network_title = nullptr;
+    std::vector<WifiNetwork> ui_networks;
+    uint32_t ui_scan_version = 0;
 
 
 
@@ -0,0 +1,98 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#include "VirtualList.h"
+
+#define VIRTUAL_LIST_OVERSCAN 2 // Rows kept bound above and below the viewport
+
+void VirtualList::create(lv_obj_t *parent, lv_coord_t w, lv_coord_t h, lv_coord_t row_h, lv_coord_t row_gap,
+                         CreateRowCb create_cb, BindRowCb bind, void *data) {
+    reset();
+
+    row_height = row_h;
+    pitch = row_h + row_gap;
+    bind_cb = bind;
+    user_data = data;
+
+    // Plain scroll container - rows are positioned by hand, no flex layout pass
+    cont = lv_obj_create(parent);
+    lv_obj_set_size(cont, w, h);
+    lv_obj_set_style_bg_opa(cont, 0, 0);
+    lv_obj_set_style_border_width(cont, 0, 0);
+    lv_obj_set_style_pad_all(cont, 0, 0);
+    lv_obj_set_scroll_dir(cont, LV_DIR_VER);
+    lv_obj_add_event_cb(cont, scrollEventCb, LV_EVENT_SCROLL, this);
+
+    size_t pool_size = (h + pitch - 1) / pitch + 1 + (2 * VIRTUAL_LIST_OVERSCAN);
+
+    for (size_t i = 0; i < pool_size; i++) {
+        lv_obj_t* row = create_cb(cont, user_data);
+        lv_obj_set_height(row, row_height);
+        lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+        pool.push_back(row);
+        bound.push_back(-1);
+    }
+}
+
+void VirtualList::reset() {
+    cont = nullptr;
+    footer = nullptr;
+    count = 0;
+    pool.clear();
+    bound.clear();
+}
+
+void VirtualList::setCount(size_t new_count) {
+    if (cont == nullptr) return;
+
+    count = new_count;
+    for (int32_t& index : bound) index = -1;
+    layout();
+}
+
+void VirtualList::setFooter(lv_obj_t *obj, lv_coord_t gap) {
+    footer = obj;
+    footer_gap = gap;
+    layout();
+}
+
+void VirtualList::layout() {
+    if (cont == nullptr || pool.empty()) return;
+
+    int32_t first = lv_obj_get_scroll_y(cont) / pitch - VIRTUAL_LIST_OVERSCAN;
+    if (first < 0) first = 0;
+
+    // Each item always lands in the same pool slot, so scrolling one row
+    // only rebinds the one row that came into range
+    for (size_t n = 0; n < pool.size(); n++) {
+        int32_t index = first + n;
+        size_t slot = index % pool.size();
+        lv_obj_t* row = pool[slot];
+
+        if (index >= (int32_t)count) {
+            if (bound[slot] != -1 || !lv_obj_has_flag(row, LV_OBJ_FLAG_HIDDEN)) {
+                lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+                bound[slot] = -1;
+            }
+            continue;
+        }
+
+        if (bound[slot] != index) {
+            bind_cb(row, index, user_data);
+            lv_obj_align(row, LV_ALIGN_TOP_MID, 0, index * pitch);
+            lv_obj_clear_flag(row, LV_OBJ_FLAG_HIDDEN);
+            bound[slot] = index;
+        }
+    }
+
+    // Footer sits after the last row and gives the container its scroll height
+    if (footer) {
+        lv_obj_align(footer, LV_ALIGN_TOP_MID, 0, count * pitch + footer_gap);
+    }
+}
+
+void VirtualList::scrollEventCb(lv_event_t *e) {
+    VirtualList* list = (VirtualList*)lv_event_get_user_data(e);
+    list->layout();
+}
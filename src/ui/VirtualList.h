@@ -0,0 +1,55 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+#ifndef VIRTUALLIST_H
+#define VIRTUALLIST_H
+
+#include <lvgl.h>
+#include <vector>
+
+// Scrolling list that only ever owns enough rows to fill the viewport plus a
+// small overscan. Rows are recycled and rebound as the list scrolls, so the
+// object count stays the same however many items there are
+class VirtualList {
+public:
+    typedef lv_obj_t* (*CreateRowCb)(lv_obj_t* parent, void* user_data);
+    typedef void (*BindRowCb)(lv_obj_t* row, size_t index, void* user_data);
+
+    void create(lv_obj_t* parent, lv_coord_t w, lv_coord_t h, lv_coord_t row_height, lv_coord_t row_gap,
+                CreateRowCb create_cb, BindRowCb bind_cb, void* user_data);
+
+    // Forget the objects (they're deleted with their screen)
+    void reset();
+
+    // Item count changed or data was replaced - rebinds the visible rows, keeps the scroll position
+    void setCount(size_t count);
+
+    // Object placed after the last row (e.g. "Connect Manually")
+    void setFooter(lv_obj_t* footer, lv_coord_t gap);
+
+    lv_obj_t* getContainer() const { return cont; }
+    size_t getPoolSize() const { return pool.size(); }
+
+private:
+    lv_obj_t* cont = nullptr;
+    lv_obj_t* footer = nullptr;
+    lv_coord_t footer_gap = 0;
+
+    lv_coord_t row_height = 0;
+    lv_coord_t pitch = 0;
+    size_t count = 0;
+
+    std::vector<lv_obj_t*> pool;
+    std::vector<int32_t> bound;     // Item each pool row currently shows, -1 if none
+
+    BindRowCb bind_cb = nullptr;
+    void* user_data = nullptr;
+
+    void layout();
+    static void scrollEventCb(lv_event_t* e);
+};
+
+
+
+#endif //VIRTUALLIST_H
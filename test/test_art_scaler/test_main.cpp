@@ -0,0 +1,183 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+// Host tests for ArtScaler - run with `pio test -e native`
+
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ui/ArtScaler.h"
+
+#define SRC_SIZE 300
+#define BIG_SIZE 365
+#define SMALL_SIZE 100
+
+static uint16_t src[SRC_SIZE * SRC_SIZE];
+static uint16_t dst[BIG_SIZE * BIG_SIZE];
+static uint16_t streamed[BIG_SIZE * BIG_SIZE];
+
+static void fill(uint16_t* px, int count, uint16_t colour) {
+    for (int i = 0; i < count; i++) px[i] = colour;
+}
+
+static void expectSolid(const uint16_t* px, int w, int h, int stride, uint16_t colour) {
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) TEST_ASSERT_EQUAL_HEX16(colour, px[y * stride + x]);
+    }
+}
+
+static int channelDiff(uint16_t a, uint16_t b) {
+    int dr = abs((a >> 11) - (b >> 11));
+    int dg = abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F));
+    int db = abs((a & 0x1F) - (b & 0x1F));
+    return dr > dg ? (dr > db ? dr : db) : (dg > db ? dg : db);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// --- Tap Tables ---
+static void test_taps_sum_to_one() {
+    const ArtScaleMode modes[] = { ART_SCALE_AREA, ART_SCALE_BILINEAR };
+    const int sizes[][2] = { {300, 100}, {300, 365}, {640, 300}, {640, 64}, {64, 365}, {300, 300} };
+
+    for (ArtScaleMode mode : modes) {
+        for (auto& size : sizes) {
+            ArtTapTable taps;
+            TEST_ASSERT_TRUE(taps.build(size[0], size[1], mode));
+
+            for (int d = 0; d < size[1]; d++) {
+                int sum = 0;
+                for (int i = 0; i < taps.count[d]; i++) sum += taps.weights[d * taps.max_taps + i];
+                TEST_ASSERT_EQUAL_INT(32, sum);
+
+                // Never reads past the source
+                TEST_ASSERT_TRUE(taps.first[d] >= 0);
+                TEST_ASSERT_TRUE(taps.first[d] + taps.count[d] <= size[0]);
+            }
+        }
+    }
+}
+
+// --- Scaling ---
+static void test_solid_colour_survives() {
+    const uint16_t colours[] = { 0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F, 0x1DB9 };
+
+    for (uint16_t colour : colours) {
+        fill(src, SRC_SIZE * SRC_SIZE, colour);
+
+        TEST_ASSERT_TRUE(ArtScaler::scale(src, SRC_SIZE, SRC_SIZE, dst, SMALL_SIZE, SMALL_SIZE, SMALL_SIZE, ART_SCALE_AREA));
+        expectSolid(dst, SMALL_SIZE, SMALL_SIZE, SMALL_SIZE, colour);
+
+        TEST_ASSERT_TRUE(ArtScaler::scale(src, SRC_SIZE, SRC_SIZE, dst, BIG_SIZE, BIG_SIZE, BIG_SIZE, ART_SCALE_BILINEAR));
+        expectSolid(dst, BIG_SIZE, BIG_SIZE, BIG_SIZE, colour);
+    }
+}
+
+static void test_same_size_is_a_copy() {
+    for (int i = 0; i < SRC_SIZE * SRC_SIZE; i++) src[i] = (uint16_t)(i * 2654435761u >> 16);
+
+    TEST_ASSERT_TRUE(ArtScaler::scale(src, SRC_SIZE, SRC_SIZE, dst, SRC_SIZE, SRC_SIZE, SRC_SIZE,
+                                      ArtScaler::pickMode(SRC_SIZE, SRC_SIZE)));
+    TEST_ASSERT_EQUAL_MEMORY(src, dst, sizeof(src));
+}
+
+static void test_area_averages_checkerboard() {
+    // Black / white 1px checks, every output pixel covers equal amounts of both
+    for (int y = 0; y < SRC_SIZE; y++) {
+        for (int x = 0; x < SRC_SIZE; x++) src[y * SRC_SIZE + x] = ((x + y) & 1) ? 0xFFFF : 0x0000;
+    }
+
+    const int half = SRC_SIZE / 2;
+    TEST_ASSERT_TRUE(ArtScaler::scale(src, SRC_SIZE, SRC_SIZE, dst, half, half, half, ART_SCALE_AREA));
+
+    const uint16_t grey = (15 << 11) | (31 << 5) | 15;
+    for (int i = 0; i < half * half; i++) TEST_ASSERT_TRUE(channelDiff(grey, dst[i]) <= 1);
+}
+
+static void test_bilinear_gradient_is_monotonic() {
+    // Red ramp left to right has to stay a ramp when grown
+    for (int y = 0; y < SRC_SIZE; y++) {
+        for (int x = 0; x < SRC_SIZE; x++) src[y * SRC_SIZE + x] = (uint16_t)((x * 31 / (SRC_SIZE - 1)) << 11);
+    }
+
+    TEST_ASSERT_TRUE(ArtScaler::scale(src, SRC_SIZE, SRC_SIZE, dst, BIG_SIZE, BIG_SIZE, BIG_SIZE, ART_SCALE_BILINEAR));
+
+    for (int y = 0; y < BIG_SIZE; y++) {
+        for (int x = 1; x < BIG_SIZE; x++) {
+            TEST_ASSERT_TRUE((dst[y * BIG_SIZE + x] >> 11) >= (dst[y * BIG_SIZE + x - 1] >> 11));
+        }
+    }
+    TEST_ASSERT_EQUAL_HEX16(0x0000, dst[0]);
+    TEST_ASSERT_EQUAL_HEX16(0xF800, dst[BIG_SIZE - 1]);
+}
+
+static void test_stride_leaves_the_rest_alone() {
+    fill(src, SRC_SIZE * SRC_SIZE, 0x07E0);
+    fill(dst, BIG_SIZE * BIG_SIZE, 0xABCD);
+
+    TEST_ASSERT_TRUE(ArtScaler::scale(src, SRC_SIZE, SRC_SIZE, dst, SMALL_SIZE, SMALL_SIZE, BIG_SIZE, ART_SCALE_AREA));
+
+    for (int y = 0; y < BIG_SIZE; y++) {
+        for (int x = 0; x < BIG_SIZE; x++) {
+            uint16_t expected = (x < SMALL_SIZE && y < SMALL_SIZE) ? 0x07E0 : 0xABCD;
+            TEST_ASSERT_EQUAL_HEX16(expected, dst[y * BIG_SIZE + x]);
+        }
+    }
+}
+
+// --- Stream ---
+static int rows_seen = 0;
+
+static void countRow(const uint16_t* row, int width, void* ctx) {
+    (void)row;
+    TEST_ASSERT_EQUAL_INT(*(int*)ctx, width);
+    rows_seen++;
+}
+
+static void test_stream_matches_one_shot() {
+    for (int i = 0; i < SRC_SIZE * SRC_SIZE; i++) src[i] = (uint16_t)(i * 40503u);
+
+    const int sizes[] = { SMALL_SIZE, BIG_SIZE };
+    for (int size : sizes) {
+        ArtScaleMode mode = ArtScaler::pickMode(SRC_SIZE, size);
+        TEST_ASSERT_TRUE(ArtScaler::scale(src, SRC_SIZE, SRC_SIZE, dst, size, size, size, mode));
+
+        ArtScaleStream stream;
+        int width = size;
+        rows_seen = 0;
+        stream.setRowCallback(countRow, &width);
+        TEST_ASSERT_TRUE(stream.begin(SRC_SIZE, SRC_SIZE, streamed, size, size, size, mode));
+
+        for (int y = 0; y < SRC_SIZE; y++) {
+            TEST_ASSERT_FALSE(stream.isComplete());
+            stream.pushRow(&src[y * SRC_SIZE]);
+        }
+
+        TEST_ASSERT_TRUE(stream.isComplete());
+        TEST_ASSERT_EQUAL_INT(size, rows_seen);
+        TEST_ASSERT_EQUAL_MEMORY(dst, streamed, size * size * sizeof(uint16_t));
+    }
+}
+
+static void test_rejects_bad_input() {
+    TEST_ASSERT_FALSE(ArtScaler::scale(nullptr, SRC_SIZE, SRC_SIZE, dst, SMALL_SIZE, SMALL_SIZE, SMALL_SIZE, ART_SCALE_AREA));
+    TEST_ASSERT_FALSE(ArtScaler::scale(src, 0, SRC_SIZE, dst, SMALL_SIZE, SMALL_SIZE, SMALL_SIZE, ART_SCALE_AREA));
+    TEST_ASSERT_FALSE(ArtScaler::scale(src, SRC_SIZE, SRC_SIZE, nullptr, SMALL_SIZE, SMALL_SIZE, SMALL_SIZE, ART_SCALE_AREA));
+    TEST_ASSERT_FALSE(ArtScaler::scale(src, SRC_SIZE, SRC_SIZE, dst, 0, SMALL_SIZE, SMALL_SIZE, ART_SCALE_AREA));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_taps_sum_to_one);
+    RUN_TEST(test_solid_colour_survives);
+    RUN_TEST(test_same_size_is_a_copy);
+    RUN_TEST(test_area_averages_checkerboard);
+    RUN_TEST(test_bilinear_gradient_is_monotonic);
+    RUN_TEST(test_stride_leaves_the_rest_alone);
+    RUN_TEST(test_stream_matches_one_shot);
+    RUN_TEST(test_rejects_bad_input);
+    return UNITY_END();
+}
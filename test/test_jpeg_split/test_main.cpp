@@ -0,0 +1,482 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+// Host tests for JpegSplit - run with `pio test -e native`
+// Images are built straight from quantised coefficients (no DCT needed) and
+// read back with a bit-at-a-time reference decoder, so a band can be checked
+// coefficient for coefficient against the rows it was cut from
+
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "ui/JpegSplit.h"
+
+#define MCUS_X 5
+#define MCUS_Y 6
+#define BLOCKS_PER_MCU 6    // 2x2 luma, Cb, Cr
+#define IMG_W (MCUS_X * 16 - 3)
+#define IMG_H (MCUS_Y * 16 - 5)
+
+struct Block {
+    int16_t c[64];  // Zigzag order
+};
+
+struct Table {
+    uint8_t bits[17];
+    std::vector<uint8_t> vals;
+};
+
+struct TestImage {
+    std::vector<Block> blocks;  // MCU order, BLOCKS_PER_MCU per MCU
+    Table dc[2];
+    Table ac;
+    uint16_t restart_interval = 0;
+    uint8_t sof = 0xC0;
+    uint8_t components = 3;
+};
+
+static uint32_t seed;
+
+static int nextRandom(int range) {
+    seed = seed * 1103515245 + 12345;
+    return (int)((seed >> 16) % range);
+}
+
+static int category(int v) {
+    int a = abs(v), s = 0;
+    for (; a; a >>= 1) s++;
+    return s;
+}
+
+// Symbols all on one length
+static Table flatTable(const std::vector<uint8_t>& vals, int len) {
+    Table t = {};
+    t.bits[len] = vals.size();
+    t.vals = vals;
+    return t;
+}
+
+// --- Encoder ---
+
+struct Writer {
+    std::vector<uint8_t> out;
+    uint32_t acc = 0;
+    int bits = 0;
+
+    void put(uint32_t v, int n) {
+        for (int i = n - 1; i >= 0; i--) {
+            acc = (acc << 1) | ((v >> i) & 1);
+            if (++bits == 8) {
+                out.push_back(acc);
+                if ((acc & 0xFF) == 0xFF) out.push_back(0x00);
+                acc = 0;
+                bits = 0;
+            }
+        }
+    }
+
+    void flush() {
+        if (bits) put(0xFF, 8 - bits);
+    }
+};
+
+static bool codeFor(const Table& t, uint8_t sym, uint32_t& code, int& len) {
+    uint32_t c = 0;
+    size_t k = 0;
+    for (int l = 1; l <= 16; l++) {
+        for (int i = 0; i < t.bits[l]; i++, k++, c++) {
+            if (t.vals[k] == sym) {
+                code = c;
+                len = l;
+                return true;
+            }
+        }
+        c <<= 1;
+    }
+    return false;
+}
+
+static void putSymbol(Writer& w, const Table& t, uint8_t sym) {
+    uint32_t code = 0;
+    int len = 0;
+    if (!codeFor(t, sym, code, len)) abort();  // Test data outside its own tables
+    w.put(code, len);
+}
+
+static void putValue(Writer& w, int v) {
+    int s = category(v);
+    if (s) w.put(v < 0 ? v - 1 : v, s);
+}
+
+static void segment(std::vector<uint8_t>& out, uint8_t marker, const std::vector<uint8_t>& body) {
+    out.push_back(0xFF);
+    out.push_back(marker);
+    out.push_back((body.size() + 2) >> 8);
+    out.push_back((body.size() + 2) & 0xFF);
+    out.insert(out.end(), body.begin(), body.end());
+}
+
+static void tableBody(std::vector<uint8_t>& body, uint8_t id, const Table& t) {
+    body.push_back(id);
+    body.insert(body.end(), &t.bits[1], &t.bits[17]);
+    body.insert(body.end(), t.vals.begin(), t.vals.end());
+}
+
+static std::vector<uint8_t> encode(const TestImage& img) {
+    std::vector<uint8_t> out = { 0xFF, 0xD8 };
+
+    std::vector<uint8_t> dqt = { 0x00 };
+    for (int i = 0; i < 64; i++) dqt.push_back(1);
+    segment(out, 0xDB, dqt);
+
+    std::vector<uint8_t> sof = { 8, IMG_H >> 8, IMG_H & 0xFF, IMG_W >> 8, IMG_W & 0xFF, img.components };
+    for (int i = 0; i < img.components; i++) {
+        sof.push_back(i + 1);
+        sof.push_back(i == 0 ? 0x22 : 0x11);
+        sof.push_back(0);
+    }
+    segment(out, img.sof, sof);
+
+    std::vector<uint8_t> dht;
+    tableBody(dht, 0x00, img.dc[0]);
+    tableBody(dht, 0x01, img.dc[1]);
+    tableBody(dht, 0x10, img.ac);
+    tableBody(dht, 0x11, img.ac);
+    segment(out, 0xC4, dht);
+
+    if (img.restart_interval) {
+        segment(out, 0xDD, { (uint8_t)(img.restart_interval >> 8), (uint8_t)(img.restart_interval & 0xFF) });
+    }
+
+    std::vector<uint8_t> sos = { img.components };
+    for (int i = 0; i < img.components; i++) {
+        sos.push_back(i + 1);
+        sos.push_back(i == 0 ? 0x00 : 0x11);
+    }
+    sos.insert(sos.end(), { 0, 63, 0 });
+    segment(out, 0xDA, sos);
+
+    Writer w;
+    int pred[3] = {};
+    for (size_t b = 0; b < img.blocks.size(); b++) {
+        int slot = b % BLOCKS_PER_MCU;
+        int comp = slot < 4 ? 0 : slot - 3;
+        const Table& dc = img.dc[comp ? 1 : 0];
+        const int16_t* c = img.blocks[b].c;
+
+        int diff = c[0] - pred[comp];
+        pred[comp] = c[0];
+        putSymbol(w, dc, category(diff));
+        putValue(w, diff);
+
+        int run = 0;
+        for (int k = 1; k < 64; k++) {
+            if (!c[k]) {
+                run++;
+                continue;
+            }
+            for (; run > 15; run -= 16) putSymbol(w, img.ac, 0xF0);
+            putSymbol(w, img.ac, (run << 4) | category(c[k]));
+            putValue(w, c[k]);
+            run = 0;
+        }
+        if (run) putSymbol(w, img.ac, 0x00);
+    }
+    w.flush();
+
+    out.insert(out.end(), w.out.begin(), w.out.end());
+    out.push_back(0xFF);
+    out.push_back(0xD9);
+    return out;
+}
+
+// --- Reference Decoder ---
+
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+    int bit = 0;
+    bool failed = false;
+
+    int next() {
+        if (p >= end || (p[0] == 0xFF && (p + 1 >= end || p[1] != 0x00))) {
+            failed = true;
+            return 0;
+        }
+        int v = (*p >> (7 - bit)) & 1;
+        if (++bit == 8) {
+            bit = 0;
+            p += *p == 0xFF ? 2 : 1;
+        }
+        return v;
+    }
+
+    int get(int n) {
+        int v = 0;
+        for (int i = 0; i < n; i++) v = (v << 1) | next();
+        return v;
+    }
+};
+
+static int readSymbol(Reader& r, const Table& t) {
+    uint32_t code = 0;
+    for (int l = 1; l <= 16 && !r.failed; l++) {
+        code = (code << 1) | r.next();
+        uint32_t c = 0;
+        size_t k = 0;
+        for (int len = 1; len <= l; len++) {
+            for (int i = 0; i < t.bits[len]; i++, k++, c++) {
+                if (len == l && c == code) return t.vals[k];
+            }
+            c <<= 1;
+        }
+    }
+    r.failed = true;
+    return 0;
+}
+
+static int readValue(Reader& r, int s) {
+    if (!s) return 0;
+    int v = r.get(s);
+    return v < (1 << (s - 1)) ? v - ((1 << s) - 1) : v;
+}
+
+struct Decoded {
+    uint16_t width = 0;
+    uint16_t height = 0;
+    int dht_segments = 0;
+    std::vector<Block> blocks;
+    bool ok = false;
+};
+
+static Decoded decodeJpeg(const uint8_t* jpg, size_t len) {
+    Decoded d;
+    Table tables[4];
+    size_t pos = 2;
+
+    while (pos + 4 <= len && jpg[pos] == 0xFF) {
+        uint8_t marker = jpg[pos + 1];
+        size_t seg_len = (jpg[pos + 2] << 8) | jpg[pos + 3];
+        const uint8_t* seg = &jpg[pos + 4];
+
+        if (marker == 0xC0) {
+            d.height = (seg[1] << 8) | seg[2];
+            d.width = (seg[3] << 8) | seg[4];
+        } else if (marker == 0xC4) {
+            d.dht_segments++;
+            size_t at = 0;
+            while (at + 17 <= seg_len - 2) {
+                Table& t = tables[(seg[at] >> 4) * 2 + (seg[at] & 0x0F)];
+                memcpy(&t.bits[1], &seg[at + 1], 16);
+                int count = 0;
+                for (int l = 1; l <= 16; l++) count += t.bits[l];
+                t.vals.assign(&seg[at + 17], &seg[at + 17 + count]);
+                at += 17 + count;
+            }
+        } else if (marker == 0xDA) {
+            pos += 2 + seg_len;
+            break;
+        }
+        pos += 2 + seg_len;
+    }
+
+    int mcus = MCUS_X * ((d.height + 15) / 16);
+    Reader r = { &jpg[pos], &jpg[len] };
+    int pred[3] = {};
+
+    for (int b = 0; b < mcus * BLOCKS_PER_MCU && !r.failed; b++) {
+        int slot = b % BLOCKS_PER_MCU;
+        int comp = slot < 4 ? 0 : slot - 3;
+        Block blk = {};
+
+        pred[comp] += readValue(r, readSymbol(r, tables[comp ? 1 : 0]));
+        blk.c[0] = pred[comp];
+
+        for (int k = 1; k < 64 && !r.failed;) {
+            int rs = readSymbol(r, tables[comp ? 3 : 2]);
+            if (!(rs & 0x0F)) {
+                if (rs != 0xF0) break;
+                k += 16;
+                continue;
+            }
+            k += rs >> 4;
+            if (k > 63) r.failed = true;
+            else blk.c[k++] = readValue(r, rs & 0x0F);
+        }
+        d.blocks.push_back(blk);
+    }
+
+    d.ok = !r.failed;
+    return d;
+}
+
+// --- Fixtures ---
+
+// Luma DC only carries the categories its differences need, so an absolute
+// DC at the start of a band always has to be added to it
+static TestImage makeImage(uint32_t image_seed) {
+    seed = image_seed;
+    TestImage img;
+    img.dc[0] = flatTable({ 0, 1, 2, 3, 4, 5 }, 3);
+    img.dc[1] = flatTable({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 }, 4);
+
+    std::vector<uint8_t> ac = { 0x00, 0xF0 };
+    for (int run = 0; run < 16; run++) {
+        for (int s = 1; s <= 3; s++) ac.push_back((run << 4) | s);
+    }
+    // Uses the whole code space so runs of 1s (and stuffed bytes) turn up
+    img.ac = flatTable(ac, 6);
+    img.ac.bits[5] = 14;
+    img.ac.bits[6] = ac.size() - 14;
+
+    // Luma starts small enough for its own table and climbs away from it
+    int dc[3] = { 10, -60, 40 };
+    for (int b = 0; b < MCUS_X * MCUS_Y * BLOCKS_PER_MCU; b++) {
+        int slot = b % BLOCKS_PER_MCU;
+        int comp = slot < 4 ? 0 : slot - 3;
+        Block blk = {};
+
+        dc[comp] += comp ? nextRandom(41) - 20 : nextRandom(11);
+        blk.c[0] = dc[comp];
+
+        // Sparse, with long zero runs now and then for ZRL
+        int k = 1 + nextRandom(4);
+        while (k < 64) {
+            blk.c[k] = (nextRandom(2) ? 1 : -1) * (1 + nextRandom(7));
+            k += 1 + (nextRandom(6) ? nextRandom(3) : 16 + nextRandom(20));
+        }
+        img.blocks.push_back(blk);
+    }
+    return img;
+}
+
+static size_t headerLength(const std::vector<uint8_t>& jpg) {
+    size_t pos = 2;
+    while (jpg[pos + 1] != 0xDA) pos += 2 + ((jpg[pos + 2] << 8) | jpg[pos + 3]);
+    return pos + 2 + ((jpg[pos + 2] << 8) | jpg[pos + 3]);
+}
+
+static void expectBandMatches(const std::vector<uint8_t>& jpg, const TestImage& img, uint16_t row) {
+    size_t band_len = 0;
+    uint8_t* band = JpegSplit::lowerBand(jpg.data(), jpg.size(), row, band_len);
+    TEST_ASSERT_TRUE(band != nullptr);
+
+    Decoded d = decodeJpeg(band, band_len);
+    free(band);
+
+    TEST_ASSERT_TRUE(d.ok);
+    TEST_ASSERT_EQUAL_INT(IMG_W, d.width);
+    TEST_ASSERT_EQUAL_INT(IMG_H - row * 16, d.height);
+
+    size_t first = (size_t)row * MCUS_X * BLOCKS_PER_MCU;
+    TEST_ASSERT_EQUAL_INT(img.blocks.size() - first, d.blocks.size());
+    for (size_t b = 0; b < d.blocks.size(); b++) {
+        TEST_ASSERT_EQUAL_MEMORY(img.blocks[first + b].c, d.blocks[b].c, sizeof(Block));
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_reference_round_trip() {
+    TestImage img = makeImage(1);
+    std::vector<uint8_t> jpg = encode(img);
+
+    Decoded d = decodeJpeg(jpg.data(), jpg.size());
+    TEST_ASSERT_TRUE(d.ok);
+    TEST_ASSERT_EQUAL_INT(img.blocks.size(), d.blocks.size());
+    for (size_t b = 0; b < d.blocks.size(); b++) {
+        TEST_ASSERT_EQUAL_MEMORY(img.blocks[b].c, d.blocks[b].c, sizeof(Block));
+    }
+
+    // The fixture has to exercise byte stuffing
+    bool stuffed = false;
+    for (size_t i = headerLength(jpg); i + 1 < jpg.size(); i++) stuffed = stuffed || (jpg[i] == 0xFF && jpg[i + 1] == 0x00);
+    TEST_ASSERT_TRUE(stuffed);
+}
+
+static void test_band_matches_every_row() {
+    for (uint32_t s = 1; s <= 4; s++) {
+        TestImage img = makeImage(s);
+        std::vector<uint8_t> jpg = encode(img);
+        TEST_ASSERT_TRUE(JpegSplit::supported(jpg.data(), jpg.size()));
+
+        for (uint16_t row = 1; row < MCUS_Y; row++) expectBandMatches(jpg, img, row);
+    }
+}
+
+static void test_missing_dc_category_is_added() {
+    TestImage img = makeImage(7);
+    std::vector<uint8_t> jpg = encode(img);
+
+    size_t band_len = 0;
+    uint8_t* band = JpegSplit::lowerBand(jpg.data(), jpg.size(), 3, band_len);
+    TEST_ASSERT_TRUE(band != nullptr);
+
+    // Luma DC is redefined, the complete chroma table isn't
+    Decoded d = decodeJpeg(band, band_len);
+    TEST_ASSERT_EQUAL_INT(2, d.dht_segments);
+    TEST_ASSERT_TRUE(band_len > jpg.size() / 3);
+
+    std::vector<uint8_t> copy(band, band + band_len);
+    free(band);
+    TEST_ASSERT_EQUAL_INT(headerLength(jpg) + 4 + 17 + 6 + 1, headerLength(copy));
+}
+
+static void test_complete_tables_are_kept() {
+    TestImage img = makeImage(3);
+    img.dc[0] = img.dc[1];
+    std::vector<uint8_t> jpg = encode(img);
+
+    size_t band_len = 0;
+    uint8_t* band = JpegSplit::lowerBand(jpg.data(), jpg.size(), 2, band_len);
+    TEST_ASSERT_TRUE(band != nullptr);
+
+    Decoded d = decodeJpeg(band, band_len);
+    free(band);
+    TEST_ASSERT_EQUAL_INT(1, d.dht_segments);
+    expectBandMatches(jpg, img, 2);
+}
+
+static void test_rejects_what_it_cant_cut() {
+    TestImage img = makeImage(5);
+    size_t band_len = 0;
+
+    // Restart markers have their own split
+    TestImage rst = img;
+    rst.restart_interval = MCUS_X;
+    std::vector<uint8_t> jpg = encode(rst);
+    TEST_ASSERT_FALSE(JpegSplit::supported(jpg.data(), jpg.size()));
+    TEST_ASSERT_TRUE(JpegSplit::lowerBand(jpg.data(), jpg.size(), 2, band_len) == nullptr);
+
+    TestImage progressive = img;
+    progressive.sof = 0xC2;
+    jpg = encode(progressive);
+    TEST_ASSERT_FALSE(JpegSplit::supported(jpg.data(), jpg.size()));
+
+    // A full luma DC table has nowhere to put a new category
+    TestImage full = img;
+    full.dc[0] = flatTable({ 0, 1, 2, 3, 4, 5, 6, 7 }, 3);
+    jpg = encode(full);
+    TEST_ASSERT_FALSE(JpegSplit::supported(jpg.data(), jpg.size()));
+
+    // Out of range rows and a scan cut short
+    jpg = encode(img);
+    TEST_ASSERT_TRUE(JpegSplit::lowerBand(jpg.data(), jpg.size(), 0, band_len) == nullptr);
+    TEST_ASSERT_TRUE(JpegSplit::lowerBand(jpg.data(), jpg.size(), MCUS_Y, band_len) == nullptr);
+    TEST_ASSERT_TRUE(JpegSplit::lowerBand(jpg.data(), headerLength(jpg) + 40, 4, band_len) == nullptr);
+    TEST_ASSERT_TRUE(JpegSplit::lowerBand(nullptr, 0, 1, band_len) == nullptr);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reference_round_trip);
+    RUN_TEST(test_band_matches_every_row);
+    RUN_TEST(test_missing_dc_category_is_added);
+    RUN_TEST(test_complete_tables_are_kept);
+    RUN_TEST(test_rejects_what_it_cant_cut);
+    return UNITY_END();
+}
@@ -0,0 +1,64 @@
+//
+// Created by Harry Skerritt on 19/10/2026.
+//
+
+// Host tests for the parser's field truncation - run with `pio test -e native`
+
+#include <unity.h>
+#include <string.h>
+
+#include "spotify/Utf8.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void expectCopy(size_t dst_len, const char* src, const char* expected) {
+    char dst[16];
+    memset(dst, 'x', sizeof(dst));
+
+    size_t written = utf8Copy(dst, dst_len, src);
+    TEST_ASSERT_EQUAL_STRING(expected, dst);
+    TEST_ASSERT_EQUAL_UINT32(strlen(expected), written);
+    TEST_ASSERT_EQUAL_CHAR('x', dst[dst_len]);     // Nothing past the buffer
+}
+
+static void test_fits() {
+    expectCopy(6, "abcde", "abcde");
+    expectCopy(6, "", "");
+    expectCopy(6, nullptr, "");
+    expectCopy(8, "caf\xc3\xa9", "caf\xc3\xa9");
+}
+
+static void test_ascii_truncates_like_strlcpy() {
+    expectCopy(6, "abcdefgh", "abcde");
+    expectCopy(1, "abc", "");
+}
+
+static void test_whole_character_at_the_end_is_kept() {
+    expectCopy(6, "abc\xc3\xa9xyz", "abc\xc3\xa9");                // 2 byte
+    expectCopy(7, "ab\xe6\x97\xa5xyz", "ab\xe6\x97\xa5x");          // 3 byte
+    expectCopy(6, "a\xf0\x9f\x98\x80xyz", "a\xf0\x9f\x98\x80");     // 4 byte
+}
+
+static void test_cut_character_is_dropped() {
+    expectCopy(6, "abcd\xc3\xa9", "abcd");                          // Lead byte only
+    expectCopy(6, "abc\xe6\x97\xa5", "abc");                        // 2 of 3
+    expectCopy(6, "ab\xf0\x9f\x98\x80", "ab");                      // 3 of 4
+    expectCopy(4, "\xe6\x97\xa5\xe6\x9c\xac", "\xe6\x97\xa5");      // Next one cut at its lead
+    expectCopy(3, "\xe6\x97\xa5", "");                              // Nothing whole fits
+}
+
+static void test_stray_continuation_bytes_are_left() {
+    // Not valid UTF-8 to begin with - only ever cut, never grown
+    expectCopy(4, "\x80\x80\x80\x80", "\x80\x80\x80");
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fits);
+    RUN_TEST(test_ascii_truncates_like_strlcpy);
+    RUN_TEST(test_whole_character_at_the_end_is_kept);
+    RUN_TEST(test_cut_character_is_dropped);
+    RUN_TEST(test_stray_continuation_bytes_are_left);
+    return UNITY_END();
+}
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+#
+# Created by Harry Skerritt on 19/10/2026.
+#
+# Bakes a static image into the AssetStore format so it ships in the LittleFS
+# image instead of being fetched and baked on the first boot:
+#
+#   python3 tools/bake_asset.py
+#   python3 tools/bake_asset.py not_playing_album.jpg
+#   pio run -t uploadfs
+#
+# Output is the "ASA1" header (magic, width, height) followed by little-endian
+# RGB565 pixels, the same layout AssetStore::write produces on the device.
+# Needs Pillow (pip install pillow)
+
+import argparse
+import io
+import os
+import struct
+import sys
+import urllib.request
+
+SOURCE_URL = "https://raw.githubusercontent.com/Harry-Skerritt/files/refs/heads/main/not_playing_album.jpg"
+OUTPUT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "data", "assets", "not_playing_365.bin")
+
+ASSET_MAGIC = 0x31415341  # "ASA1"
+ASSET_SIZE = 365          # Matches AssetStore's ASSETS table
+
+
+def load_image(source):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("bake_asset: needs Pillow - pip install pillow")
+
+    if source.startswith("http://") or source.startswith("https://"):
+        with urllib.request.urlopen(source, timeout=30) as response:
+            data = response.read()
+        return Image.open(io.BytesIO(data))
+    return Image.open(source)
+
+
+def to_rgb565(image, size):
+    from PIL import Image
+
+    # Centre crop to square first, the art slot is square
+    w, h = image.size
+    side = min(w, h)
+    left, top = (w - side) // 2, (h - side) // 2
+    image = image.convert("RGB").crop((left, top, left + side, top + side))
+    image = image.resize((size, size), Image.LANCZOS)
+
+    out = bytearray(size * size * 2)
+    i = 0
+    for r, g, b in image.getdata():
+        struct.pack_into("<H", out, i, ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3))
+        i += 2
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Bake an image into an AssetStore .bin")
+    parser.add_argument("source", nargs="?", default=SOURCE_URL, help="Image file or URL, the not playing art if omitted")
+    parser.add_argument("-o", "--output", default=OUTPUT, help="Where to write the .bin")
+    parser.add_argument("--size", type=int, default=ASSET_SIZE, help="Square edge in pixels")
+    args = parser.parse_args()
+
+    pixels = to_rgb565(load_image(args.source), args.size)
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, "wb") as f:
+        f.write(struct.pack("<IHH", ASSET_MAGIC, args.size, args.size))
+        f.write(pixels)
+
+    print("bake_asset: wrote %s (%dx%d, %d bytes)" % (args.output, args.size, args.size, 8 + len(pixels)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+#
+# Created by Harry Skerritt on 19/10/2026.
+#
+# Decodes the TraceLog stream (~T lines) in a serial log back into readable events.
+# Everything else passes straight through, so it works as a filter on the monitor:
+#
+#   pio device monitor | python3 tools/trace_decode.py
+#   python3 tools/trace_decode.py capture.log
+#
+# Event names and formats come from the enum comments in src/system/TraceLog.h
+
+import argparse
+import os
+import re
+import sys
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "system", "TraceLog.h")
+
+ENUM_RE = re.compile(r"enum TraceEventId[^{]*\{(.*?)\};", re.S)
+ENTRY_RE = re.compile(r"^\s*(TRACE_\w+)\s*,?\s*(?://\s*(.*))?$")
+EVENT_RE = re.compile(r"^~T(\d) ([0-9a-f]{8}) ([0-9a-f]{4}) ([0-9a-f]{8}) ([0-9a-f]{8})$")
+DROP_RE = re.compile(r"^~D (\d+)$")
+
+
+def load_events(path):
+    with open(path) as f:
+        body = ENUM_RE.search(f.read())
+    if not body:
+        sys.exit("trace_decode: no TraceEventId enum in " + path)
+
+    events = []
+    for line in body.group(1).splitlines():
+        m = ENTRY_RE.match(line)
+        if m:
+            events.append((m.group(1), (m.group(2) or "").strip()))
+    return events
+
+
+def signed(v):
+    return v - (1 << 32) if v & 0x80000000 else v
+
+
+def decode(events, core, t_us, event_id, a, b):
+    if event_id < len(events):
+        name, fmt = events[event_id]
+    else:
+        name, fmt = "TRACE_%d" % event_id, "a={a} b={b}"
+
+    fields = {"a": a, "b": b, "as": signed(a), "bs": signed(b), "ah": a >> 16, "al": a & 0xFFFF}
+    try:
+        text = fmt.format(**fields) if fmt else name
+    except (KeyError, ValueError, IndexError):
+        text = "%s a=%d b=%d" % (name, a, b)
+
+    return "[%10.3f ms c%d] %s" % (t_us / 1000.0, core, text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode TraceLog lines in a serial log")
+    parser.add_argument("log", nargs="?", help="Serial log, stdin if omitted")
+    parser.add_argument("--header", default=HEADER, help="TraceLog.h to read event ids from")
+    parser.add_argument("--only", action="store_true", help="Drop lines that aren't trace events")
+    args = parser.parse_args()
+
+    events = load_events(args.header)
+    source = open(args.log, errors="replace") if args.log else sys.stdin
+
+    for raw in source:
+        line = raw.rstrip("\r\n")
+
+        m = EVENT_RE.match(line)
+        if m:
+            core, t_us, event_id, a, b = m.groups()
+            print(decode(events, int(core), int(t_us, 16), int(event_id, 16), int(a, 16), int(b, 16)), flush=True)
+            continue
+
+        m = DROP_RE.match(line)
+        if m:
+            print("[trace] %s events dropped" % m.group(1), flush=True)
+            continue
+
+        if not args.only:
+            print(line, flush=True)
+
+
+if __name__ == "__main__":
+    main()